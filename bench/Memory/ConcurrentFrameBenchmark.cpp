@@ -0,0 +1,202 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Ek/Memory/ConcurrentFrameAllocator.hpp"
+#include "Ek/Memory/FrameAllocator.hpp"
+#include "Ek/Memory/ThreadAllocator.hpp"
+
+/*
+** ConcurrentFrameBenchmark [max threads]
+** Stress: threads swap freshly built messages with random cells of a shared
+** table, then check and free the message they took out, which is often one
+** of another thread. A slot handed out twice shows up as a broken message.
+** Contention: threads allocate and free messages as fast as they can.
+*/
+
+/* Cells of the shared message table */
+#define STRESS_CELL_COUNT 4096
+
+/* Message exchanges done by each thread */
+#define STRESS_ITERATIONS 1000000
+
+/* Allocate/free pairs done by each thread */
+#define CONTENTION_ITERATIONS 2000000
+
+/* Messages held by each thread at once */
+#define CONTENTION_WINDOW_SIZE 16
+
+typedef struct s_message {
+  std::uint64_t serial;
+  std::uint64_t check;
+  char payload[48];
+} t_message;
+
+/* A mutex around a single FrameAllocator */
+class LockedFrameAllocator
+{
+private:
+  std::mutex _mutex;
+  ek::FrameAllocator _allocator;
+
+public:
+  LockedFrameAllocator() :
+    _allocator(DEFAULT_PAGE_SIZE, sizeof(t_message))
+  {
+  }
+
+  void *allocate(std::uint64_t const size)
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+
+    return (this->_allocator.allocate(size));
+  }
+
+  void free(void *ptr)
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+
+    this->_allocator.free(ptr);
+  }
+};
+
+/* Per-thread FrameAllocators, with remote frees */
+class LocalFrameAllocator
+{
+public:
+  void *allocate(std::uint64_t const size)
+  {
+    return (ek::ThreadAllocator<ek::FrameAllocator>::local().allocate(size));
+  }
+
+  void free(void *ptr)
+  {
+    ek::ThreadAllocator<ek::FrameAllocator>::local().free(ptr);
+  }
+};
+
+static bool stress(unsigned int const threadCount)
+{
+  ek::ConcurrentFrameAllocator allocator(DEFAULT_PAGE_SIZE, sizeof(t_message));
+  std::vector<std::atomic<t_message *>> cells(STRESS_CELL_COUNT);
+  std::atomic<std::uint64_t> errors(0);
+  std::vector<std::thread> threads;
+
+  for (std::atomic<t_message *> &cell : cells)
+    cell.store(nullptr);
+  for (unsigned int t = 0; t < threadCount; t++)
+    threads.emplace_back([&, t]() {
+      std::mt19937 random(t);
+      t_message *message;
+
+      for (std::uint64_t i = 0; i < STRESS_ITERATIONS; i++)
+      {
+        message = (t_message *) allocator.allocate(sizeof(t_message));
+        message->serial = (((std::uint64_t) t) << 32) | i;
+        message->check = ~message->serial;
+        message = cells[random() % STRESS_CELL_COUNT].exchange(message, std::memory_order_acq_rel);
+        if (message)
+        {
+          if (message->check != ~message->serial)
+            errors++;
+          allocator.free(message);
+        }
+      }
+    });
+  for (std::thread &thread : threads)
+    thread.join();
+  for (std::atomic<t_message *> &cell : cells)
+    if (cell.load())
+      allocator.free(cell.load());
+  std::cout << "stress\t" << threadCount << " threads\t" << allocator.getPageCount() << " pages\t" << errors.load() << " errors" << std::endl;
+  return (errors.load() == 0);
+}
+
+/* Nanoseconds per allocate/free pair */
+template <typename Alloc>
+static double contention(Alloc &allocator, unsigned int const threadCount)
+{
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point end;
+  std::vector<std::thread> threads;
+
+  start = std::chrono::steady_clock::now();
+  for (unsigned int t = 0; t < threadCount; t++)
+    threads.emplace_back([&allocator]() {
+      void *window[CONTENTION_WINDOW_SIZE] = { nullptr };
+      std::uint64_t index;
+
+      for (std::uint64_t i = 0; i < CONTENTION_ITERATIONS; i++)
+      {
+        index = i % CONTENTION_WINDOW_SIZE;
+        if (window[index])
+          allocator.free(window[index]);
+        window[index] = allocator.allocate(sizeof(t_message));
+        ((t_message *) window[index])->serial = i;
+      }
+      for (void *ptr : window)
+        allocator.free(ptr);
+    });
+  for (std::thread &thread : threads)
+    thread.join();
+  end = std::chrono::steady_clock::now();
+  return (std::chrono::duration<double, std::nano>(end - start).count() / CONTENTION_ITERATIONS);
+}
+
+int main(int argc, char **argv)
+{
+  unsigned int maxThreads = (argc > 1) ? std::atoi(argv[1]) : std::thread::hardware_concurrency();
+  double concurrentTime;
+  double lockedTime;
+  double localTime;
+  bool success = true;
+
+  if (maxThreads < 2)
+    maxThreads = 2;
+  for (unsigned int threadCount = 2; threadCount <= maxThreads; threadCount *= 2)
+    success = stress(threadCount) && success;
+
+  std::cout << "threads\tconcurrent (ns/op)\tlocked (ns/op)\tthread local (ns/op)" << std::endl;
+  for (unsigned int threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+  {
+    ek::ConcurrentFrameAllocator concurrentAllocator(DEFAULT_PAGE_SIZE, sizeof(t_message));
+    LockedFrameAllocator lockedAllocator;
+    LocalFrameAllocator localAllocator;
+
+    concurrentTime = contention(concurrentAllocator, threadCount);
+    lockedTime = contention(lockedAllocator, threadCount);
+    localTime = contention(localAllocator, threadCount);
+    std::cout << threadCount << "\t" << concurrentTime << "\t" << lockedTime << "\t" << localTime << std::endl;
+  }
+
+  /* Done! */
+  return (success ? 0 : 1);
+}
\ No newline at end of file
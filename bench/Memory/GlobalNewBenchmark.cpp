@@ -0,0 +1,144 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+#include <vector>
+
+/*
+** Same workload through the global operator new/delete, replaced by Ek's
+** GlobalNew.cpp in this executable, and through glibc malloc/free.
+*/
+
+/* Live blocks kept by each thread */
+#define BENCH_WINDOW_SIZE 4096
+
+/* Allocations done by each thread */
+#define BENCH_ITERATIONS 4000000
+
+typedef void *(*t_alloc_function)(std::size_t);
+typedef void (*t_free_function)(void *);
+
+static void *newAlloc(std::size_t size)
+{
+  return (::operator new(size));
+}
+
+static void newFree(void *ptr)
+{
+  ::operator delete(ptr);
+}
+
+static void *mallocAlloc(std::size_t size)
+{
+  return (std::malloc(size));
+}
+
+static void mallocFree(void *ptr)
+{
+  std::free(ptr);
+}
+
+/* Mostly small blocks, as seen from containers and strings, with a few big ones */
+static std::size_t nextSize(std::uint64_t &seed)
+{
+  std::uint64_t random;
+
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+  random = seed >> 32;
+  if (random % 100 < 90)
+    return (8 + random % 248);
+  if (random % 100 < 99)
+    return (256 + random % 768);
+  return (1024 + random % 65536);
+}
+
+static void workload(t_alloc_function allocFunction, t_free_function freeFunction, std::uint64_t seed)
+{
+  std::vector<char *> window(BENCH_WINDOW_SIZE, nullptr);
+  std::uint64_t index;
+  std::size_t size;
+
+  for (std::uint64_t i = 0; i < BENCH_ITERATIONS; i++)
+  {
+    size = nextSize(seed);
+    index = seed % BENCH_WINDOW_SIZE;
+    if (window[index])
+      freeFunction(window[index]);
+    window[index] = (char *) allocFunction(size);
+    window[index][0] = (char) i;
+  }
+  for (char *ptr : window)
+    if (ptr)
+      freeFunction(ptr);
+}
+
+/* Nanoseconds per allocate/free pair */
+static double run(t_alloc_function allocFunction, t_free_function freeFunction, unsigned int threadCount)
+{
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point end;
+  std::vector<std::thread> threads;
+
+  start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < threadCount; i++)
+    threads.emplace_back(workload, allocFunction, freeFunction, 0x9E3779B97F4A7C15ULL + i);
+  for (std::thread &thread : threads)
+    thread.join();
+  end = std::chrono::steady_clock::now();
+  return (std::chrono::duration<double, std::nano>(end - start).count() / BENCH_ITERATIONS);
+}
+
+int main(int argc, char **argv)
+{
+  unsigned int maxThreads = std::thread::hardware_concurrency();
+  double newTime;
+  double mallocTime;
+
+  /* The biggest thread count can be given as first argument */
+  if (argc > 1)
+    maxThreads = std::atoi(argv[1]);
+  if (maxThreads == 0)
+    maxThreads = 1;
+
+  /* Warm up both allocators */
+  run(newAlloc, newFree, 1);
+  run(mallocAlloc, mallocFree, 1);
+
+  std::cout << "threads\tek new (ns/op)\tglibc malloc (ns/op)" << std::endl;
+  for (unsigned int threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+  {
+    newTime = run(newAlloc, newFree, threadCount);
+    mallocTime = run(mallocAlloc, mallocFree, threadCount);
+    std::cout << threadCount << "\t" << newTime << "\t" << mallocTime << std::endl;
+  }
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
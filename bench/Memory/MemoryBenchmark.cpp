@@ -0,0 +1,325 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Ek/Memory/FrameAllocator.hpp"
+#include "Ek/Memory/StackAllocator.hpp"
+
+/*
+** ek-bench-memory [output.json] [max threads]
+** Each thread owns its allocator and runs rounds of BENCH_BLOCK_COUNT allocations
+** followed by BENCH_BLOCK_COUNT frees, in the order given by the pattern.
+** Latencies are timed over batches of BENCH_BATCH_SIZE operations: short
+** enough to see the slow ones, long enough for the clock not to weigh.
+** Each case runs in a process of its own, so its memory is its own.
+*/
+
+/* Blocks allocated then freed by each round */
+#define BENCH_BLOCK_COUNT 1024
+
+/* Rounds run by each thread */
+#define BENCH_ROUND_COUNT 500
+
+/* Operations timed together, BENCH_BLOCK_COUNT being a multiple of it */
+#define BENCH_BATCH_SIZE 16
+
+/* Block size of the fixed size patterns */
+#define BENCH_BLOCK_SIZE 64
+
+/* Biggest block of the mixed sizes pattern, and frame slot size */
+#define BENCH_MAX_BLOCK_SIZE 256
+
+typedef enum e_bench_pattern {
+  BENCH_LIFO,
+  BENCH_FIFO,
+  BENCH_RANDOM,
+  BENCH_MIXED
+} t_bench_pattern;
+
+typedef struct s_bench_thread {
+  std::vector<double> samples;
+  std::uint64_t peakPages;
+} t_bench_thread;
+
+/* Sent back by the process of a case */
+typedef struct s_bench_stats {
+  double mean;
+  double p50;
+  double p90;
+  double p99;
+  double max;
+  long peakRss;
+  long rssGrowth;
+  std::uint64_t peakPages;
+} t_bench_stats;
+
+typedef struct s_bench_result {
+  std::string allocator;
+  std::string pattern;
+  unsigned int threads;
+  t_bench_stats stats;
+} t_bench_result;
+
+/* Reference: the system allocator, without pages of its own */
+class MallocAllocator
+{
+public:
+  void *allocate(std::uint64_t const size)
+  {
+    return (std::malloc(size));
+  }
+
+  void free(void *ptr)
+  {
+    std::free(ptr);
+  }
+
+  std::uint64_t getPageCount() const
+  {
+    return (0);
+  }
+};
+
+template <typename Alloc>
+static Alloc *createAllocator()
+{
+  return (new Alloc());
+}
+
+template <>
+ek::FrameAllocator *createAllocator<ek::FrameAllocator>()
+{
+  return (new ek::FrameAllocator(DEFAULT_PAGE_SIZE, BENCH_MAX_BLOCK_SIZE));
+}
+
+static char const *patternName(t_bench_pattern const pattern)
+{
+  static char const *names[] = { "lifo", "fifo", "random", "mixed" };
+
+  return (names[pattern]);
+}
+
+/* Free order and block sizes of the next round */
+static void prepareRound(t_bench_pattern const pattern, std::mt19937 &random, std::vector<std::uint32_t> &order, std::vector<std::uint64_t> &sizes)
+{
+  for (std::uint32_t i = 0; i < BENCH_BLOCK_COUNT; i++)
+  {
+    order[i] = (pattern == BENCH_LIFO) ? BENCH_BLOCK_COUNT - 1 - i : i;
+    sizes[i] = (pattern == BENCH_MIXED) ? 8 + random() % (BENCH_MAX_BLOCK_SIZE - 7) : BENCH_BLOCK_SIZE;
+  }
+  if (pattern == BENCH_RANDOM || pattern == BENCH_MIXED)
+    std::shuffle(order.begin(), order.end(), random);
+}
+
+template <typename Alloc>
+static void benchThread(t_bench_pattern const pattern, unsigned int const seed, t_bench_thread *result)
+{
+  std::vector<std::uint32_t> order(BENCH_BLOCK_COUNT);
+  std::vector<std::uint64_t> sizes(BENCH_BLOCK_COUNT);
+  std::vector<char *> blocks(BENCH_BLOCK_COUNT);
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point end;
+  std::mt19937 random(seed);
+  Alloc *allocator = createAllocator<Alloc>();
+
+  result->peakPages = 0;
+  result->samples.reserve(BENCH_ROUND_COUNT * 2 * BENCH_BLOCK_COUNT / BENCH_BATCH_SIZE);
+  for (unsigned int round = 0; round < BENCH_ROUND_COUNT; round++)
+  {
+    prepareRound(pattern, random, order, sizes);
+    for (std::uint32_t batch = 0; batch < BENCH_BLOCK_COUNT; batch += BENCH_BATCH_SIZE)
+    {
+      start = std::chrono::steady_clock::now();
+      for (std::uint32_t i = batch; i < batch + BENCH_BATCH_SIZE; i++)
+      {
+        blocks[i] = (char *) allocator->allocate(sizes[i]);
+        blocks[i][0] = (char) i;
+      }
+      end = std::chrono::steady_clock::now();
+      result->samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / BENCH_BATCH_SIZE);
+    }
+    result->peakPages = std::max(result->peakPages, allocator->getPageCount());
+    for (std::uint32_t batch = 0; batch < BENCH_BLOCK_COUNT; batch += BENCH_BATCH_SIZE)
+    {
+      start = std::chrono::steady_clock::now();
+      for (std::uint32_t i = batch; i < batch + BENCH_BATCH_SIZE; i++)
+        allocator->free(blocks[order[i]]);
+      end = std::chrono::steady_clock::now();
+      result->samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / BENCH_BATCH_SIZE);
+    }
+  }
+  delete allocator;
+}
+
+static double percentile(std::vector<double> const &samples, double const ratio)
+{
+  return (samples[std::min(samples.size() - 1, (std::size_t) (ratio * samples.size()))]);
+}
+
+/* Runs a case in the calling process */
+template <typename Alloc>
+static t_bench_stats runCase(t_bench_pattern const pattern, unsigned int const threadCount)
+{
+  std::vector<t_bench_thread> threadResults(threadCount);
+  std::vector<std::thread> threads;
+  std::vector<double> samples;
+  t_bench_stats stats;
+  struct rusage usage;
+  long startRss;
+
+  getrusage(RUSAGE_SELF, &usage);
+  startRss = usage.ru_maxrss;
+
+  for (unsigned int i = 0; i < threadCount; i++)
+    threads.emplace_back(benchThread<Alloc>, pattern, 42 + i, &threadResults[i]);
+  for (std::thread &thread : threads)
+    thread.join();
+
+  stats.mean = 0;
+  stats.peakPages = 0;
+  for (t_bench_thread const &threadResult : threadResults)
+  {
+    samples.insert(samples.end(), threadResult.samples.begin(), threadResult.samples.end());
+    stats.peakPages += threadResult.peakPages;
+  }
+  std::sort(samples.begin(), samples.end());
+  for (double sample : samples)
+    stats.mean += sample;
+  stats.mean /= samples.size();
+  stats.p50 = percentile(samples, 0.5);
+  stats.p90 = percentile(samples, 0.9);
+  stats.p99 = percentile(samples, 0.99);
+  stats.max = samples.back();
+
+  /* Peak of this process, in kilobytes, and how far the case raised it (samples included) */
+  getrusage(RUSAGE_SELF, &usage);
+  stats.peakRss = usage.ru_maxrss;
+  stats.rssGrowth = usage.ru_maxrss - startRss;
+  return (stats);
+}
+
+/* Runs a case in a child process: the peak RSS only grows, it must not carry over */
+template <typename Alloc>
+static t_bench_result bench(char const *name, t_bench_pattern const pattern, unsigned int const threadCount)
+{
+  t_bench_result result;
+  t_bench_stats stats;
+  int fds[2];
+  pid_t pid;
+
+  result.allocator = name;
+  result.pattern = patternName(pattern);
+  result.threads = threadCount;
+  result.stats = {};
+
+  if (pipe(fds) != 0 || (pid = fork()) < 0)
+  {
+    std::cerr << "ek-bench-memory: Cannot fork, " << name << " " << result.pattern << " runs in this process" << std::endl;
+    result.stats = runCase<Alloc>(pattern, threadCount);
+    return (result);
+  }
+  if (pid == 0)
+  {
+    close(fds[0]);
+    stats = runCase<Alloc>(pattern, threadCount);
+    _exit(write(fds[1], &stats, sizeof(stats)) == sizeof(stats) ? 0 : 1);
+  }
+
+  close(fds[1]);
+  if (read(fds[0], &stats, sizeof(stats)) == sizeof(stats))
+    result.stats = stats;
+  else
+    std::cerr << "ek-bench-memory: No result from " << name << " " << result.pattern << std::endl;
+  close(fds[0]);
+  waitpid(pid, nullptr, 0);
+  return (result);
+}
+
+static void writeJson(std::ostream &stream, std::vector<t_bench_result> const &results)
+{
+  stream << "{" << std::endl << "  \"benchmarks\": [" << std::endl;
+  for (std::size_t i = 0; i < results.size(); i++)
+  {
+    t_bench_result const &result = results[i];
+
+    stream << "    {"
+           << "\"allocator\": \"" << result.allocator << "\", "
+           << "\"pattern\": \"" << result.pattern << "\", "
+           << "\"threads\": " << result.threads << ", "
+           << "\"ns_per_op\": " << result.stats.mean << ", "
+           << "\"p50_ns\": " << result.stats.p50 << ", "
+           << "\"p90_ns\": " << result.stats.p90 << ", "
+           << "\"p99_ns\": " << result.stats.p99 << ", "
+           << "\"max_ns\": " << result.stats.max << ", "
+           << "\"peak_rss_kb\": " << result.stats.peakRss << ", "
+           << "\"rss_growth_kb\": " << result.stats.rssGrowth << ", "
+           << "\"peak_pages\": " << result.stats.peakPages
+           << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+  }
+  stream << "  ]" << std::endl << "}" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+  std::string output = (argc > 1) ? argv[1] : "ek-bench-memory.json";
+  unsigned int maxThreads = (argc > 2) ? std::atoi(argv[2]) : std::thread::hardware_concurrency();
+  t_bench_pattern const patterns[] = { BENCH_LIFO, BENCH_FIFO, BENCH_RANDOM, BENCH_MIXED };
+  std::vector<t_bench_result> results;
+  std::ofstream file;
+
+  if (maxThreads == 0)
+    maxThreads = 1;
+  for (unsigned int threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+    for (t_bench_pattern pattern : patterns)
+    {
+      results.push_back(bench<MallocAllocator>("malloc", pattern, threadCount));
+      results.push_back(bench<ek::FrameAllocator>("frame", pattern, threadCount));
+      results.push_back(bench<ek::StackAllocator>("stack", pattern, threadCount));
+    }
+
+  /* Machine readable results */
+  file.open(output);
+  if (!file)
+  {
+    std::cerr << "ek-bench-memory: Cannot open " << output << std::endl;
+    return (1);
+  }
+  writeJson(file, results);
+  std::cerr << "ek-bench-memory: " << results.size() << " results written to " << output << std::endl;
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
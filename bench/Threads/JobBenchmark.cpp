@@ -0,0 +1,180 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "Ek/Threads/JobManager.hpp"
+
+/*
+** JobBenchmark [workers]
+** Spawn: the main thread adds empty jobs, then waits for them.
+** Fork: each job adds two jobs until a depth, as a parallel divide and
+** conquer would.
+** Compute: a loop split in jobs, against the same loop on one thread.
+** Wait: jobs adding jobs and waiting for them, first on threads, where a
+** waiting job runs others on its stack, then on fibers, where it is parked.
+*/
+
+#define SPAWN_JOB_COUNT 1000000
+#define FORK_DEPTH 18
+#define COMPUTE_SIZE (1 << 24)
+#define COMPUTE_JOB_COUNT 256
+#define WAIT_PARENT_COUNT 256
+#define WAIT_CHILD_COUNT 64
+#define WAIT_FIBER_COUNT 128
+
+static void forkJobs(ek::JobManager &jobs, std::atomic<std::uint64_t> &leaves, int const depth)
+{
+  if (!depth)
+  {
+    leaves.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  jobs.run([&jobs, &leaves, depth] {
+    forkJobs(jobs, leaves, depth - 1);
+  });
+  jobs.run([&jobs, &leaves, depth] {
+    forkJobs(jobs, leaves, depth - 1);
+  });
+}
+
+static std::uint64_t compute(std::uint64_t const begin, std::uint64_t const end)
+{
+  std::uint64_t sum = 0;
+
+  for (std::uint64_t i = begin; i < end; i++)
+    sum += (i * i) ^ (i >> 3);
+  return (sum);
+}
+
+/* Each parent job splits its part of the loop in children, then waits for them */
+static std::uint64_t waitChildren(ek::JobManager &jobs)
+{
+  std::uint64_t sums[WAIT_PARENT_COUNT][WAIT_CHILD_COUNT];
+  std::uint64_t sum = 0;
+  ek::JobCounter parents;
+
+  for (int i = 0; i < WAIT_PARENT_COUNT; i++)
+  {
+    jobs.run([&jobs, &sums, i] {
+      ek::JobCounter children;
+
+      for (int j = 0; j < WAIT_CHILD_COUNT; j++)
+      {
+        jobs.run([&sums, i, j] {
+          std::uint64_t part = (std::uint64_t) i * WAIT_CHILD_COUNT + j;
+          std::uint64_t size = COMPUTE_SIZE / (WAIT_PARENT_COUNT * WAIT_CHILD_COUNT);
+
+          sums[i][j] = compute(part * size, (part + 1) * size);
+        }, &children);
+      }
+      jobs.wait(children);
+    }, &parents);
+  }
+  jobs.wait(parents);
+
+  for (int i = 0; i < WAIT_PARENT_COUNT; i++)
+    for (int j = 0; j < WAIT_CHILD_COUNT; j++)
+      sum += sums[i][j];
+  return (sum);
+}
+
+static double elapsedMs(std::chrono::steady_clock::time_point const start)
+{
+  return (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+}
+
+int main(int argc, char **argv)
+{
+  ek::JobManager jobs(argc > 1 ? std::atoi(argv[1]) : 0);
+  std::atomic<std::uint64_t> counter(0);
+  std::uint64_t sums[COMPUTE_JOB_COUNT];
+  std::uint64_t parallelSum = 0;
+  std::uint64_t serialSum;
+  std::chrono::steady_clock::time_point start;
+  double spawnTime;
+  double forkTime;
+  double parallelTime;
+  double serialTime;
+  std::uint64_t threadSum;
+  std::uint64_t fiberSum;
+  double threadTime;
+  double fiberTime;
+
+  std::cout << "Workers: " << jobs.getWorkerCount() << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < SPAWN_JOB_COUNT; i++)
+  {
+    jobs.run([&counter] {
+      counter.fetch_add(1, std::memory_order_relaxed);
+    });
+  }
+  jobs.wait();
+  spawnTime = elapsedMs(start);
+  std::cout << "Spawn: " << SPAWN_JOB_COUNT << " jobs in " << spawnTime << " ms, " << spawnTime * 1000000.0 / SPAWN_JOB_COUNT << " ns per job" << std::endl;
+
+  counter.store(0);
+  start = std::chrono::steady_clock::now();
+  forkJobs(jobs, counter, FORK_DEPTH);
+  jobs.wait();
+  forkTime = elapsedMs(start);
+  std::cout << "Fork: " << counter.load() << " leaves in " << forkTime << " ms" << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < COMPUTE_JOB_COUNT; i++)
+  {
+    jobs.run([&sums, i] {
+      sums[i] = compute((std::uint64_t) i * COMPUTE_SIZE / COMPUTE_JOB_COUNT, (std::uint64_t) (i + 1) * COMPUTE_SIZE / COMPUTE_JOB_COUNT);
+    });
+  }
+  jobs.wait();
+  parallelTime = elapsedMs(start);
+  for (std::uint64_t sum : sums)
+    parallelSum += sum;
+
+  start = std::chrono::steady_clock::now();
+  serialSum = compute(0, COMPUTE_SIZE);
+  serialTime = elapsedMs(start);
+  std::cout << "Compute: " << parallelTime << " ms in jobs, " << serialTime << " ms on one thread" << (parallelSum == serialSum ? "" : " (wrong sum)") << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  threadSum = waitChildren(jobs);
+  threadTime = elapsedMs(start);
+
+  {
+    ek::JobManager fiberJobs(jobs.getWorkerCount(), WAIT_FIBER_COUNT);
+
+    start = std::chrono::steady_clock::now();
+    fiberSum = waitChildren(fiberJobs);
+    fiberTime = elapsedMs(start);
+  }
+  std::cout << "Wait: " << threadTime << " ms on threads, " << fiberTime << " ms on fibers" << (threadSum == serialSum && fiberSum == serialSum ? "" : " (wrong sum)") << std::endl;
+
+  /* Done! */
+  return (parallelSum == serialSum && threadSum == serialSum && fiberSum == serialSum ? 0 : 1);
+}
\ No newline at end of file
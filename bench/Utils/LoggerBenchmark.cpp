@@ -0,0 +1,165 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+
+#include "Ek/Utils/AsyncLogger.hpp"
+#include "Ek/Utils/Logger.hpp"
+#include "Ek/Utils/LogFormat.hpp"
+
+/*
+** LoggerBenchmark
+** Standard output goes to a pipe read by a slow collector, then frames of
+** log lines are timed: with the synchronous streams, then through an
+** AsyncLogger dropping records on overflow, then one blocking on overflow,
+** then a binary AsyncLogger with constant format statements.
+*/
+
+/* Frames timed by each phase */
+#define FRAME_COUNT 100
+
+/* Lines logged by each frame */
+#define LINES_PER_FRAME 100
+
+/* Idle time between two frames, in milliseconds */
+#define FRAME_INTERVAL 2
+
+/* The collector reads this many bytes, then sleeps (milliseconds) */
+#define SLOW_READ_SIZE 4096
+#define SLOW_READ_DELAY 10
+
+enum Mode
+{
+  Synchronous,
+  AsyncDrop,
+  AsyncBlock,
+  AsyncBinary
+};
+
+typedef struct s_phase_result {
+  double average;
+  double max;
+  std::uint64_t dropped;
+} t_phase_result;
+
+static void logFrame(int const frame)
+{
+  using namespace ek;
+
+  for (int line = 0; line < LINES_PER_FRAME; line++)
+    LOG(LOG_LEVEL_DEBUG, "DEB Frame " << frame << ": entity " << line << " moved to " << line * 0.5f << ", " << frame * 0.25f);
+}
+
+static void logFrameFormat(int const frame)
+{
+  for (int line = 0; line < LINES_PER_FRAME; line++)
+    LOG_FMT(LOG_LEVEL_DEBUG, "Frame {}: entity {} moved to {}, {}", frame, line, line * 0.5f, frame * 0.25f);
+}
+
+static t_phase_result runPhase(Mode const mode)
+{
+  t_phase_result result = {0.0, 0.0, 0};
+  std::unique_ptr<ek::AsyncLogger> logger;
+  int savedOut;
+  int fds[2];
+
+  if (pipe(fds) != 0)
+  {
+    std::cerr << "Cannot create a pipe" << std::endl;
+    return (result);
+  }
+
+  std::thread collector([fd = fds[0]] {
+    char buffer[SLOW_READ_SIZE];
+
+    while (read(fd, buffer, sizeof(buffer)) > 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(SLOW_READ_DELAY));
+  });
+
+  std::cout.flush();
+  savedOut = dup(1);
+  dup2(fds[1], 1);
+
+  if (mode == AsyncBinary)
+    logger.reset(new ek::AsyncLogger(1, ek::AsyncLogger::Drop, DEFAULT_LOG_RING_SIZE, ek::AsyncLogger::Binary));
+  else if (mode != Synchronous)
+    logger.reset(new ek::AsyncLogger(1, mode == AsyncDrop ? ek::AsyncLogger::Drop : ek::AsyncLogger::Block));
+
+  for (int frame = 0; frame < FRAME_COUNT; frame++)
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double elapsed;
+
+    if (mode == AsyncBinary)
+      logFrameFormat(frame);
+    else
+      logFrame(frame);
+    elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.average += elapsed / FRAME_COUNT;
+    if (elapsed > result.max)
+      result.max = elapsed;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(FRAME_INTERVAL));
+  }
+
+  if (logger)
+  {
+    result.dropped = logger->getDroppedCount();
+    logger.reset();
+  }
+
+  std::cout.flush();
+  dup2(savedOut, 1);
+  close(savedOut);
+  close(fds[1]);
+  collector.join();
+  close(fds[0]);
+  return (result);
+}
+
+static void printResult(char const *name, t_phase_result const &result)
+{
+  std::cout << name << ": average frame " << result.average << " ms, worst frame " << result.max << " ms, " << result.dropped << " records dropped" << std::endl;
+}
+
+int main()
+{
+  t_phase_result synchronous = runPhase(Synchronous);
+  t_phase_result asyncDrop = runPhase(AsyncDrop);
+  t_phase_result asyncBlock = runPhase(AsyncBlock);
+  t_phase_result asyncBinary = runPhase(AsyncBinary);
+
+  std::cout << FRAME_COUNT << " frames of " << LINES_PER_FRAME << " lines, slow collector on stdout" << std::endl;
+  printResult("Synchronous", synchronous);
+  printResult("Async, drop", asyncDrop);
+  printResult("Async, block", asyncBlock);
+  printResult("Async, binary, drop", asyncBinary);
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <cstdint>
+#include <iostream>
+
+#include "Ek/Memory/FrameAllocator.hpp"
+#include "Ek/Memory/StackAllocator.hpp"
+
+/* SIMD friendly data */
+struct alignas(32) Vector8
+{
+  float values[8];
+};
+
+/* Per-thread counter, alone on its cache line */
+struct alignas(CACHE_LINE_SIZE) PaddedCounter
+{
+  std::uint64_t value;
+};
+
+int main()
+{
+  /* Frame slots are aligned on the biggest power of two dividing their size */
+  ek::FrameAllocator frameAllocator(DEFAULT_PAGE_SIZE, sizeof(PaddedCounter));
+
+  /* Stack slots are padded as needed */
+  ek::StackAllocator stackAllocator;
+
+  PaddedCounter *counter;
+  Vector8 *vector;
+  char *page;
+
+  /* ALLOC_NEW asks for the alignment of the type */
+  counter = ALLOC_NEW(frameAllocator, PaddedCounter);
+  vector = ALLOC_NEW(stackAllocator, Vector8);
+
+  /* Raw data can be aligned on a page */
+  page = (char *) stackAllocator.allocate(4096, 4096);
+
+  std::cout << "Counter: " << (void *) counter << std::endl;
+  std::cout << "Vector: " << (void *) vector << std::endl;
+  std::cout << "Page: " << (void *) page << std::endl;
+
+  /* Destruction */
+  ALLOC_FREE(stackAllocator, page);
+  ALLOC_FREE(stackAllocator, vector);
+  ALLOC_FREE(frameAllocator, counter);
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <iostream>
+
+#include "Ek/Memory/AllocationTracer.hpp"
+#include "Ek/Memory/FrameAllocator.hpp"
+#include "Ek/Memory/StackAllocator.hpp"
+#include "../SampleClass.hpp"
+
+/* Forgets one class out of 100 */
+static void leakyFunction(ek::FrameAllocator &allocator, int i)
+{
+  SampleClass *myClass = ALLOC_NEW(allocator, SampleClass, i, i);
+
+  if (i % 100 != 0)
+    ALLOC_FREE(allocator, myClass);
+}
+
+/* Allocates a lot of temporary data */
+static void hotFunction(ek::StackAllocator &allocator)
+{
+  ek::StackScope scope(allocator);
+
+  for (int i = 0; i < 100; i++)
+    ALLOC_NEW(allocator, char[256]);
+}
+
+int main()
+{
+#if !defined(EK_ALLOCATION_TRACING)
+  std::cout << "Allocations are only traced when Ek is built with EK_ALLOCATION_TRACING" << std::endl;
+#endif
+
+  /* Local allocators creation */
+  ek::FrameAllocator frameAllocator;
+  ek::StackAllocator stackAllocator;
+
+  /* One allocation out of 16 is traced, on average */
+  ek::AllocationTracer::setSampleRate(16);
+
+  for (int i = 0; i < 10000; i++)
+    leakyFunction(frameAllocator, i);
+  for (int i = 0; i < 1000; i++)
+    hotFunction(stackAllocator);
+
+  /* Leaks are the sites with live bytes, hot spots the ones with high rates */
+  ek::AllocationTracer::report(std::cout);
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <iostream>
+
+#include "Ek/Memory/DoubleFrameArena.hpp"
+#include "../SampleClass.hpp"
+
+int main()
+{
+  /* Local arena creation */
+  ek::DoubleFrameArena arena;
+
+  /* Data built during the last frame, read during the current one */
+  SampleClass *lastFrame = nullptr;
+  SampleClass *currentFrame;
+
+  for (int frame = 0; frame < 4; frame++)
+  {
+    /* Transient allocations: no free needed */
+    currentFrame = ALLOC_NEW(arena, SampleClass, frame, frame * frame);
+    for (int i = 0; i < 1000; i++)
+      ALLOC_NEW(arena, char[64]);
+
+    /* The previous frame data is still valid */
+    if (lastFrame)
+      std::cout << "Last: " << *lastFrame << " Current: " << *currentFrame << std::endl;
+    lastFrame = currentFrame;
+
+    /* Frame boundary, usually right after ek::Window::display() */
+    arena.swap();
+  }
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
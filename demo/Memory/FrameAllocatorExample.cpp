@@ -63,6 +63,22 @@ int main()
   /* Data destruction */
   ALLOC_FREE(allocator, myData);
 
+  /* Batch of classes, built in neighbouring slots */
+  SampleClass *myClasses[16];
+
+  ALLOC_NEW_ARRAY(allocator, SampleClass, 16, myClasses, 1, 2);
+  std::cout << *myClasses[0] << " ... " << *myClasses[15] << std::endl;
+  ALLOC_DELETE_ARRAY(allocator, myClasses, 16);
+
+  /* After a burst, empty pages are kept for reuse until trimmed */
+  SampleClass *burst[8192];
+
+  ALLOC_NEW_ARRAY(allocator, SampleClass, 8192, burst);
+  ALLOC_DELETE_ARRAY(allocator, burst, 8192);
+  std::cout << "Pages: " << allocator.getPageCount() << std::endl;
+  allocator.trim(1);
+  std::cout << "Pages after trim: " << allocator.getPageCount() << std::endl;
+
   /* Done! */
   return (0);
 }
\ No newline at end of file
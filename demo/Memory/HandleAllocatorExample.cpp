@@ -0,0 +1,70 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <chrono>
+#include <iostream>
+
+#include "Ek/Memory/HandleAllocator.hpp"
+#include "../SampleClass.hpp"
+
+int main()
+{
+  /* Local allocator creation */
+  ek::HandleAllocator allocator;
+
+  /* Handles are kept instead of pointers */
+  ek::HandleAllocator::Handle handles[8];
+  ek::HandleAllocator::Handle handle;
+
+  /* Class allocations */
+  for (int i = 0; i < 8; i++)
+  {
+    handles[i] = allocator.allocate(sizeof(SampleClass));
+    new (allocator.get(handles[i])) SampleClass(i, i * i);
+  }
+
+  /* Every other class is freed: the heap has holes */
+  for (int i = 0; i < 8; i += 2)
+    allocator.free(handles[i]);
+  std::cout << "Used: " << allocator.getUsedSize() << " bytes, holes: " << allocator.getFreeSize() << " bytes" << std::endl;
+
+  /* Once per frame, with a small time budget */
+  while (!allocator.defragment(std::chrono::microseconds(50)));
+  std::cout << "Used: " << allocator.getUsedSize() << " bytes, holes: " << allocator.getFreeSize() << " bytes" << std::endl;
+
+  /* Moved classes are found again through their handle, freed ones are not */
+  std::cout << *allocator.get<SampleClass>(handles[1]) << std::endl;
+  std::cout << "Freed handle valid: " << allocator.isValid(handles[0]) << std::endl;
+
+  /* A new block reuses the entry of a freed one, with a new generation */
+  handle = allocator.allocate(sizeof(SampleClass));
+  std::cout << "Stale handle valid: " << allocator.isValid(handles[6]) << ", new handle valid: " << allocator.isValid(handle) << std::endl;
+
+  /* Destruction */
+  allocator.free(handle);
+  for (int i = 1; i < 8; i += 2)
+    allocator.free(handles[i]);
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <iostream>
+
+#include "Ek/Memory/ObjectPool.hpp"
+#include "../SampleClass.hpp"
+
+int main()
+{
+  /* Local pool creation */
+  ek::ObjectPool<SampleClass> pool(64);
+
+  /* Handles are kept instead of pointers */
+  ek::ObjectPool<SampleClass>::Handle handles[8];
+
+  /* Classes creation */
+  for (int i = 0; i < 8; i++)
+    handles[i] = pool.create(i, i * 10);
+
+  /* Destruction: the last class takes the freed place */
+  pool.destroy(handles[2]);
+  pool.destroy(handles[5]);
+
+  /* Every tick: live classes are packed, no pointer to follow */
+  for (SampleClass &myClass : pool)
+    myClass.swap();
+  for (SampleClass const &myClass : pool)
+    std::cout << myClass << std::endl;
+
+  /* Moved classes are found again through their handle, destroyed ones are not */
+  std::cout << *pool.get(handles[7]) << std::endl;
+  std::cout << "Destroyed handle valid: " << pool.isValid(handles[2]) << std::endl;
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
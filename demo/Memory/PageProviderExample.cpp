@@ -0,0 +1,65 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <iostream>
+
+#include "Ek/Memory/PageProvider.hpp"
+#include "Ek/Memory/FrameAllocator.hpp"
+#include "Ek/Memory/StackAllocator.hpp"
+#include "../SampleClass.hpp"
+
+int main()
+{
+  /* One provider for every allocator, backed by transparent huge pages */
+  ek::PageProvider provider(DEFAULT_PAGE_SIZE, DEFAULT_PAGE_RESERVE_SIZE, PAGE_PROVIDER_HUGE_PAGES);
+
+  /* Local allocators creation, plugged on the provider */
+  ek::FrameAllocator frameAllocator(DEFAULT_PAGE_SIZE, sizeof(SampleClass), &provider);
+  ek::StackAllocator stackAllocator(DEFAULT_PAGE_SIZE, &provider);
+
+  /* Any class to allocate */
+  SampleClass *myClass;
+
+  /* Or any data to allocate */
+  char *myData;
+
+  /* Allocations */
+  myClass = ALLOC_NEW(frameAllocator, SampleClass, 42, 1337);
+  std::cout << *myClass << std::endl;
+
+  /* Going back and forth over a page boundary reuses the same page */
+  for (int i = 0; i < 1000; i++)
+  {
+    myData = ALLOC_NEW(stackAllocator, char[DEFAULT_PAGE_SIZE]);
+    myData[0] = 'A';
+    ALLOC_FREE(stackAllocator, myData);
+  }
+
+  std::cout << "Reserved: " << provider.getReservedSize() << " bytes" << std::endl;
+
+  /* Class destruction */
+  ALLOC_FREE(frameAllocator, myClass);
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "Ek/Memory/ScratchAllocator.hpp"
+#include "../SampleClass.hpp"
+
+/* Temporary buffers of a function, on its own call stack */
+static void printReversed(ek::StackAllocator &stackAllocator, char const *text)
+{
+  ek::ScratchAllocator<256> scratch(stackAllocator);
+  std::uint64_t length = std::strlen(text);
+  char *reversed;
+
+  reversed = (char *) scratch.allocate(length + 1);
+  for (std::uint64_t i = 0; i < length; i++)
+    reversed[i] = text[length - 1 - i];
+  reversed[length] = 0;
+  std::cout << reversed << " (spilled: " << scratch.hasSpilled() << ")" << std::endl;
+}
+
+int main()
+{
+  /* Parent allocator, used once the inline buffer is full */
+  ek::StackAllocator stackAllocator;
+
+  /* Small temporary: served by the inline buffer */
+  printReversed(stackAllocator, "Hello World!");
+
+  /* Big temporary: spills on the stack allocator */
+  printReversed(stackAllocator, std::string(300, '-').c_str());
+
+  /* Inline buffer sized for a few classes */
+  {
+    ek::ScratchAllocator<sizeof(SampleClass) * 4> scratch(stackAllocator);
+    SampleClass *myClass;
+
+    for (int i = 0; i < 8; i++)
+    {
+      myClass = ALLOC_NEW(scratch, SampleClass, i, i * 10);
+      std::cout << *myClass << std::endl;
+    }
+    std::cout << "Spilled: " << scratch.hasSpilled() << std::endl;
+  }
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
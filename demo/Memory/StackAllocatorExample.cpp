@@ -63,6 +63,14 @@ int main()
   /* Data destruction */
   ALLOC_FREE(allocator, myData);
 
+  /* Scoped temporary memory: everything is freed at once at the end of the scope */
+  {
+    ek::StackScope scope(allocator);
+
+    for (int i = 0; i < 1000; i++)
+      ALLOC_NEW(allocator, SampleClass, i, i);
+  }
+
   /* Done! */
   return (0);
 }
\ No newline at end of file
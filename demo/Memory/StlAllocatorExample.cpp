@@ -0,0 +1,61 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "Ek/Memory/FrameAllocator.hpp"
+#include "Ek/Memory/StackAllocator.hpp"
+#include "Ek/Memory/MemoryResource.hpp"
+#include "Ek/Memory/StlAllocator.hpp"
+
+int main()
+{
+  /* Local allocators creation */
+  ek::FrameAllocator frameAllocator;
+  ek::StackAllocator stackAllocator;
+
+  /* Node based container: every node fits in a frame slot */
+  std::list<int, ek::StlAllocator<int, ek::FrameAllocator>> numbers(frameAllocator);
+
+  /* Polymorphic containers, backed by the stack allocator */
+  ek::MemoryResource<ek::StackAllocator> resource(stackAllocator);
+  std::pmr::vector<std::pmr::string> words(&resource);
+
+  for (int i = 0; i < 10; i++)
+    numbers.push_back(i * i);
+  words.emplace_back("Hello");
+  words.emplace_back("from a stack allocated vector of stack allocated strings!");
+
+  for (int number : numbers)
+    std::cout << number << " ";
+  std::cout << std::endl;
+  for (std::pmr::string const &word : words)
+    std::cout << word << " ";
+  std::cout << std::endl;
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <iostream>
+#include <thread>
+
+#include "Ek/Memory/FrameAllocator.hpp"
+#include "Ek/Memory/ThreadAllocator.hpp"
+#include "../SampleClass.hpp"
+
+typedef ek::ThreadAllocator<ek::FrameAllocator> ThreadFrameAllocator;
+
+int main()
+{
+  /* Any class to allocate */
+  SampleClass *myClass;
+
+  /* Class allocation, with the allocator of the main thread */
+  myClass = ALLOC_NEW(ThreadFrameAllocator::local(), SampleClass, 42, 1337);
+  std::cout << *myClass << std::endl;
+
+  /* Another thread uses the class and frees it: the block is sent back to the main thread */
+  std::thread worker([myClass]() {
+    SampleClass *workerClass;
+
+    /* The worker allocates with its own allocator, without any lock */
+    workerClass = ALLOC_NEW(ThreadFrameAllocator::local(), SampleClass, 72, 101);
+    myClass->swap();
+    std::cout << *myClass << std::endl;
+    std::cout << *workerClass << std::endl;
+    ALLOC_FREE(ThreadFrameAllocator::local(), workerClass);
+
+    /* Class destruction from another thread */
+    ALLOC_FREE(ThreadFrameAllocator::local(), myClass);
+  });
+  worker.join();
+
+  /* The next allocation of the main thread gets its freed block back */
+  myClass = ALLOC_NEW(ThreadFrameAllocator::local(), SampleClass);
+  std::cout << *myClass << std::endl;
+  ALLOC_FREE(ThreadFrameAllocator::local(), myClass);
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
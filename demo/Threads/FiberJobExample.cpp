@@ -0,0 +1,101 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+
+#include "Ek/Threads/JobManager.hpp"
+
+#define CHUNK_COUNT 16
+#define TILE_COUNT 64
+#define TILE_SIZE 256
+
+/* A map chunk: streamed tile by tile, then its navigation is built from the tiles */
+struct Chunk
+{
+  std::uint8_t tiles[TILE_COUNT][TILE_SIZE];
+  std::uint32_t walkable[TILE_COUNT];
+  std::uint32_t navigation;
+};
+
+static Chunk chunks[CHUNK_COUNT];
+
+/* Stands for the decompression of a tile read from disk */
+static void streamTile(Chunk &chunk, int const chunkIndex, int const tile)
+{
+  for (int i = 0; i < TILE_SIZE; i++)
+    chunk.tiles[tile][i] = (std::uint8_t) ((chunkIndex * 31 + tile * 7 + i) % 5);
+}
+
+static void buildNavigation(Chunk &chunk, int const tile)
+{
+  chunk.walkable[tile] = 0;
+  for (int i = 0; i < TILE_SIZE; i++)
+    chunk.walkable[tile] += chunk.tiles[tile][i] != 0;
+}
+
+int main()
+{
+  /* Fiber mode: a chunk job waiting for its tiles leaves the worker to other jobs */
+  ek::JobManager jobs(0, 64);
+  ek::JobCounter loaded;
+  std::atomic<std::uint32_t> total(0);
+
+  std::cout << "Workers: " << jobs.getWorkerCount() << ", fibers: " << jobs.getFiberCount() << std::endl;
+
+  for (int c = 0; c < CHUNK_COUNT; c++)
+  {
+    jobs.run([&jobs, &total, c] {
+      Chunk &chunk = chunks[c];
+      ek::JobCounter streamed;
+      ek::JobCounter navigated;
+
+      for (int t = 0; t < TILE_COUNT; t++)
+        jobs.run([&chunk, c, t] {
+          streamTile(chunk, c, t);
+        }, &streamed);
+      /* Written as straight code: the fiber is parked until every tile is in */
+      jobs.wait(streamed);
+
+      for (int t = 0; t < TILE_COUNT; t++)
+        jobs.run([&chunk, t] {
+          buildNavigation(chunk, t);
+        }, &navigated);
+      jobs.wait(navigated);
+
+      chunk.navigation = 0;
+      for (int t = 0; t < TILE_COUNT; t++)
+        chunk.navigation += chunk.walkable[t];
+      total.fetch_add(chunk.navigation, std::memory_order_relaxed);
+    }, &loaded);
+  }
+  jobs.wait(loaded);
+
+  for (int c = 0; c < CHUNK_COUNT; c++)
+    std::cout << "Chunk " << c << ": " << chunks[c].navigation << " walkable cells" << std::endl;
+  std::cout << "Total: " << total.load() << " walkable cells" << std::endl;
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#include "Ek/Threads/GameLoop.hpp"
+#include "Ek/Threads/ThreadManager.hpp"
+
+#define BALL_COUNT 4
+
+/* Mutable state of the game, copied at each tick */
+struct World
+{
+  float position[BALL_COUNT];
+  float speed[BALL_COUNT];
+};
+
+int main()
+{
+  ek::ThreadManager threads;
+  World initial = {{0.0f, 0.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 3.0f, 4.0f}};
+  /* 20 ticks per second: slow enough for the interpolation to show */
+  ek::GameLoop<World> loop(std::chrono::milliseconds(50), initial);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  float rendered = 0.0f;
+  int backwards = 0;
+  int frames = 0;
+
+  ek::ThreadManager::setCurrentName("ek-main");
+
+  threads.spawn("ek-game", [&loop](ek::ThreadManager &manager) {
+    loop.run(manager, [](World &world, float const seconds) {
+      for (int i = 0; i < BALL_COUNT; i++)
+        world.position[i] += world.speed[i] * seconds;
+    });
+  }, THREAD_ANY_CORE, ek::ThreadManager::High);
+
+  /* Main thread: renders at its own rate, here about 60 frames per second */
+  while (std::chrono::steady_clock::now() - start < std::chrono::seconds(1))
+  {
+    World const *previous;
+    World const *latest;
+    float alpha;
+    float position;
+
+    loop.update();
+    previous = &loop.getPrevious();
+    latest = &loop.getLatest();
+    alpha = loop.getAlpha();
+    position = previous->position[0] + (latest->position[0] - previous->position[0]) * alpha;
+
+    /* The speeds never change: the rendered balls must never go back */
+    if (position < rendered)
+      backwards++;
+    rendered = position;
+    if (frames % 10 == 0)
+      std::cout << "Frame " << frames << ": tick " << loop.getTick() << ", alpha " << alpha << ", ball 0 at " << position << std::endl;
+    frames++;
+
+    /* A window would display() here */
+    std::this_thread::sleep_for(std::chrono::milliseconds(16));
+  }
+
+  threads.stop();
+  threads.join();
+  std::cout << frames << " frames for " << loop.getTick() << " ticks, " << backwards << " steps back" << std::endl;
+
+  /* Done! */
+  return (backwards ? 1 : 0);
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+
+#include "Ek/Threads/JobManager.hpp"
+
+#define ENTITY_COUNT 4096
+#define BATCH_SIZE 256
+
+/* Mutable state of an entity */
+struct Entity
+{
+  float position;
+  float speed;
+  float animation;
+  float rendered;
+};
+
+static Entity entities[ENTITY_COUNT];
+
+/* Splits the entities in batches, one job each */
+template <typename F>
+static void forEachBatch(ek::JobManager &jobs, std::initializer_list<ek::JobCounter *> dependencies, ek::JobCounter &counter, F function)
+{
+  for (int begin = 0; begin < ENTITY_COUNT; begin += BATCH_SIZE)
+  {
+    jobs.runAfter(dependencies, [function, begin] {
+      for (int i = begin; i < begin + BATCH_SIZE; i++)
+        function(entities[i]);
+    }, &counter);
+  }
+}
+
+int main()
+{
+  ek::JobManager jobs;
+  std::atomic<int> particles(0);
+
+  for (int i = 0; i < ENTITY_COUNT; i++)
+    entities[i] = {0.0f, (float) (i % 7), 0.0f, 0.0f};
+
+  for (int tick = 0; tick < 3; tick++)
+  {
+    /* One counter per stage of the tick */
+    ek::JobCounter physics;
+    ek::JobCounter ai;
+    ek::JobCounter animation;
+    ek::JobCounter particleCounter;
+    ek::JobCounter renderPrep;
+    float checksum = 0.0f;
+
+    /* physics -> ai -> animation -> render prep, particles overlap with ai and animation */
+    forEachBatch(jobs, {}, physics, [](Entity &entity) {
+      entity.position += entity.speed;
+    });
+    forEachBatch(jobs, {&physics}, ai, [](Entity &entity) {
+      entity.speed = entity.position > 100.0f ? -entity.speed : entity.speed;
+    });
+    forEachBatch(jobs, {&ai}, animation, [](Entity &entity) {
+      entity.animation = entity.position * 0.5f;
+    });
+    jobs.runAfter({&physics}, [&particles] {
+      particles.fetch_add(1, std::memory_order_relaxed);
+    }, &particleCounter);
+    forEachBatch(jobs, {&animation, &particleCounter}, renderPrep, [](Entity &entity) {
+      entity.rendered = entity.position + entity.animation;
+    });
+
+    /* The main thread runs jobs of the graph instead of blocking */
+    jobs.wait(renderPrep);
+
+    for (Entity const &entity : entities)
+      checksum += entity.rendered;
+    std::cout << "Tick " << tick << ": render checksum " << checksum << ", particle updates " << particles.load() << std::endl;
+  }
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+
+#include "Ek/Threads/JobManager.hpp"
+
+#define CHUNK_COUNT 64
+#define CHUNK_SIZE 4096
+#define AGENT_COUNT 256
+
+/* Chunk of a generated map */
+struct Chunk
+{
+  std::uint32_t heights[CHUNK_SIZE];
+};
+
+static Chunk chunks[CHUNK_COUNT];
+
+static void generateChunk(void *data)
+{
+  Chunk *chunk = (Chunk *) data;
+  std::uint32_t seed = (std::uint32_t) (chunk - chunks) * 2654435761u + 1;
+
+  for (std::uint32_t i = 0; i < CHUNK_SIZE; i++)
+  {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    chunk->heights[i] = seed % 256;
+  }
+}
+
+int main()
+{
+  /* One worker per core beside this thread */
+  ek::JobManager jobs;
+  std::atomic<std::uint64_t> pathLength(0);
+  std::uint64_t total = 0;
+
+  std::cout << "Workers: " << jobs.getWorkerCount() << std::endl;
+
+  /* Map generation: one job per chunk */
+  for (Chunk &chunk : chunks)
+    jobs.run(&generateChunk, &chunk);
+
+  /* Any job can add jobs: each group of agents splits its path searches */
+  for (int group = 0; group < AGENT_COUNT / 16; group++)
+  {
+    jobs.run([&jobs, &pathLength, group] {
+      for (int agent = 0; agent < 16; agent++)
+      {
+        jobs.run([&pathLength, group, agent] {
+          pathLength.fetch_add(group * 16 + agent, std::memory_order_relaxed);
+        });
+      }
+    });
+  }
+
+  /* The main thread runs jobs too until all are done */
+  jobs.wait();
+
+  for (Chunk const &chunk : chunks)
+    for (std::uint32_t height : chunk.heights)
+      total += height;
+  std::cout << "Map checksum: " << total << std::endl;
+  std::cout << "Path length: " << pathLength.load() << std::endl;
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
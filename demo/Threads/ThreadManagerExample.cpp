@@ -0,0 +1,124 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+#include "Ek/Threads/JobManager.hpp"
+#include "Ek/Threads/ThreadManager.hpp"
+
+/* Event queue of the audio thread, which sleeps on it */
+struct AudioEvents
+{
+  std::mutex mutex;
+  std::condition_variable ready;
+  std::deque<int> sounds;
+  bool stopped = false;
+};
+
+int main()
+{
+  ek::ThreadManager threads;
+  std::uint32_t cores = ek::ThreadManager::getCoreCount();
+  /* With enough cores, game and audio get their own, the workers share the others */
+  std::uint64_t gameCore = cores >= 4 ? THREAD_CORE(0) : THREAD_ANY_CORE;
+  std::uint64_t audioCore = cores >= 4 ? THREAD_CORE(1) : THREAD_ANY_CORE;
+  std::uint64_t workerCores = cores >= 4 ? ~(THREAD_CORE(0) | THREAD_CORE(1)) : THREAD_ANY_CORE;
+  ek::JobManager jobs(cores >= 4 ? cores - 3 : 0, 0, workerCores);
+  AudioEvents audio;
+  std::atomic<std::uint32_t> ticks(0);
+  std::atomic<std::uint32_t> played(0);
+  std::atomic<std::uint32_t> polls(0);
+  std::string gameName;
+
+  ek::ThreadManager::setCurrentName("ek-main");
+
+  /* Game: fixed ticks, each one handing work to the job workers */
+  threads.spawn("ek-game", [&](ek::ThreadManager &manager) {
+    gameName = ek::ThreadManager::getCurrentName();
+    while (manager.sleepFor(std::chrono::milliseconds(16)))
+    {
+      std::atomic<int> updated(0);
+      ek::JobCounter update;
+
+      for (int i = 0; i < 8; i++)
+        jobs.run([&updated] {
+          updated.fetch_add(1, std::memory_order_relaxed);
+        }, &update);
+      jobs.wait(update);
+      ticks.fetch_add(1, std::memory_order_relaxed);
+
+      std::lock_guard<std::mutex> lock(audio.mutex);
+      audio.sounds.push_back(updated.load());
+      audio.ready.notify_one();
+    }
+  }, gameCore, ek::ThreadManager::High);
+
+  /* Audio: sleeps on its own queue, woken up by stop() through its wake function */
+  threads.spawn("ek-audio", [&](ek::ThreadManager &manager) {
+    std::unique_lock<std::mutex> lock(audio.mutex);
+
+    while (manager.isRunning())
+    {
+      audio.ready.wait(lock, [&audio] {
+        return (!audio.sounds.empty() || audio.stopped);
+      });
+      while (!audio.sounds.empty())
+      {
+        audio.sounds.pop_front();
+        played.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }, audioCore, ek::ThreadManager::High, [&audio] {
+    std::lock_guard<std::mutex> lock(audio.mutex);
+    audio.stopped = true;
+    audio.ready.notify_one();
+  });
+
+  /* Network: nothing to do most of the time */
+  threads.spawn("ek-network", [&](ek::ThreadManager &manager) {
+    while (manager.sleepFor(std::chrono::milliseconds(50)))
+      polls.fetch_add(1, std::memory_order_relaxed);
+  }, THREAD_ANY_CORE, ek::ThreadManager::Low);
+
+  /* The main thread would render here */
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  /* Stops and joins network, audio, then game */
+  threads.stop();
+  threads.join();
+
+  std::cout << ek::ThreadManager::getCurrentName() << ": " << cores << " cores, " << jobs.getWorkerCount() << " workers" << std::endl;
+  std::cout << gameName << ": " << ticks.load() << " ticks" << std::endl;
+  std::cout << "ek-audio: " << played.load() << " sounds played" << std::endl;
+  std::cout << "ek-network: " << polls.load() << " polls" << std::endl;
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+
+#include "Ek/Memory/Memory.hpp"
+
+/* Default sampling: one allocation traced out of ALLOCATION_TRACER_SAMPLE_RATE, on average */
+#define ALLOCATION_TRACER_SAMPLE_RATE 1024
+
+/* Frames kept for each call site */
+#define ALLOCATION_TRACER_MAX_FRAMES 12
+
+/* Different call sites tracked */
+#define ALLOCATION_TRACER_MAX_SITES 1024
+
+/* Sampled blocks alive at once, a power of two */
+#define ALLOCATION_TRACER_TABLE_SIZE 65536
+
+/* Entries looked at from the place of a block: past it, a sample is dropped */
+#define ALLOCATION_TRACER_MAX_PROBES 32
+
+/* Live samples counted per 4 Kb page, so a freed range without any is not searched */
+#define ALLOCATION_TRACER_PAGE_SHIFT 12
+#define ALLOCATION_TRACER_PAGE_BUCKETS 16384
+
+/* Widest range checked page by page, wider ones are searched right away */
+#define ALLOCATION_TRACER_MAX_RANGE_PAGES 1024
+
+/* Code of the allocators and the tracer, kept in a section of its own (ELF only) to be left out of the call sites */
+#if defined(EK_ALLOCATION_TRACING) && defined(__ELF__)
+  #define TRACE_ALLOCATOR_CODE __attribute__((section("ek_allocator_code")))
+#else
+  #define TRACE_ALLOCATOR_CODE
+#endif
+
+/* Hooks of the allocators, built with EK_ALLOCATION_TRACING only */
+#if defined(EK_ALLOCATION_TRACING)
+  #define TRACE_ALLOCATE(Ptr, Size) (ek::AllocationTracer::onAllocate(Ptr, Size))
+  #define TRACE_FREE(Ptr) (ek::AllocationTracer::onFree(Ptr))
+  #define TRACE_FREE_RANGE(Begin, End) (ek::AllocationTracer::onFreeRange(Begin, End))
+#else
+  #define TRACE_ALLOCATE(Ptr, Size)
+  #define TRACE_FREE(Ptr)
+  #define TRACE_FREE_RANGE(Begin, End)
+#endif
+
+namespace ek
+{
+  /*
+  ** Records a backtrace for a random sample of the allocations, and their
+  ** bytes per call site until they are freed. Counts are scaled back by the
+  ** sampling rate: the report gives estimated live bytes (leaks, at shutdown)
+  ** and allocation rates (hot spots) for each call site.
+  ** Sampled blocks sit in a lock-free table; a lock is only taken to record a
+  ** new call site. A block is only looked for in the few entries after its
+  ** place, so a free costs the same however long the program runs.
+  ** Thread-safe.
+  */
+  class AllocationTracer
+  {
+  private:
+    typedef struct s_trace_site {
+      void *frames[ALLOCATION_TRACER_MAX_FRAMES];
+      std::uint32_t frameCount;
+      std::uint64_t hash;
+      std::atomic<std::uint64_t> liveBytes;
+      std::atomic<std::uint64_t> liveBlocks;
+      std::atomic<std::uint64_t> allocatedBytes;
+      std::atomic<std::uint64_t> allocations;
+    } t_trace_site;
+
+    typedef struct s_trace_block {
+      std::atomic<std::uintptr_t> ptr;
+      std::uint32_t site;
+      std::uint64_t size;
+    } t_trace_block;
+
+    static std::uint32_t _siteOf(void * const *, std::uint32_t const);
+    static t_trace_block *_find(void *);
+    static void _sample(void *, std::uint64_t const);
+    static void _remove(t_trace_block *, std::uintptr_t);
+    static std::atomic<std::uint32_t> &_pageSamples(std::uintptr_t const);
+
+    static std::atomic<std::uint32_t> _sampleRate;
+    static std::atomic<std::uint64_t> _dropped;
+    static std::atomic<std::uint64_t> _liveSamples;
+    static std::chrono::steady_clock::time_point _start;
+
+    static std::mutex _sitesMutex;
+    static std::atomic<std::uint32_t> _siteCount;
+    static t_trace_site _sites[ALLOCATION_TRACER_MAX_SITES];
+    static t_trace_block _blocks[ALLOCATION_TRACER_TABLE_SIZE];
+    static std::atomic<std::uint32_t> _pages[ALLOCATION_TRACER_PAGE_BUCKETS];
+
+  public:
+    AllocationTracer() = delete;
+
+    static void onAllocate(void *, std::uint64_t const);
+    static void onFree(void *);
+
+    /* Every block in [begin, end[ has been freed at once (ex: stack rewind) */
+    static void onFreeRange(void *, void *);
+
+    /* 1 traces every allocation, 0 stops sampling */
+    static void setSampleRate(std::uint32_t const);
+    static std::uint32_t getSampleRate();
+
+    /* Writes the call sites of sampled blocks, most live bytes first */
+    static void report(std::ostream &);
+  };
+};
\ No newline at end of file
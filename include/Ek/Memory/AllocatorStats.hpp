@@ -0,0 +1,73 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+#include "Ek/Memory/Memory.hpp"
+
+/* Number of size histogram buckets: bucket N counts sizes in [2^(N-1), 2^N[ */
+#define ALLOCATOR_STATS_BUCKETS 32
+
+namespace ek
+{
+  class AllocatorStats
+  {
+  private:
+    std::string _name;
+
+    std::atomic<std::uint64_t> _liveBytes;
+    std::atomic<std::uint64_t> _peakBytes;
+    std::atomic<std::uint64_t> _allocations;
+    std::atomic<std::uint64_t> _histogram[ALLOCATOR_STATS_BUCKETS];
+
+    AllocatorStats *_last;
+    AllocatorStats *_next;
+
+    static std::mutex _registryMutex;
+    static AllocatorStats *_registry;
+
+  public:
+    AllocatorStats(std::string const &);
+    ~AllocatorStats();
+
+    AllocatorStats(AllocatorStats const &) = delete;
+    void operator=(AllocatorStats const &) = delete;
+
+    void onAllocate(std::uint64_t const);
+    void onFree(std::uint64_t const);
+
+    std::string const &getName() const;
+    std::uint64_t getLiveBytes() const;
+    std::uint64_t getPeakBytes() const;
+    std::uint64_t getAllocationCount() const;
+    std::uint64_t getHistogram(std::uint64_t const) const;
+
+    /* Writes the stats of every living allocator, merged by name; the peaks of several instances are summed */
+    static void report(std::ostream &);
+  };
+};
\ No newline at end of file
@@ -0,0 +1,96 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "Ek/Memory/Memory.hpp"
+#include "Ek/Memory/PageProvider.hpp"
+
+/* Default biggest number of pages: 256 Mb of 64 Kb pages */
+#define DEFAULT_CONCURRENT_FRAME_MAX_PAGES 4096
+
+namespace ek
+{
+  /*
+  ** FrameAllocator sharable between threads.
+  ** Free slots form a lock-free stack. Its head packs the index of the first
+  ** slot with a tag bumped on each change, so a head popped then pushed back
+  ** between a load and a compare-exchange (ABA) is detected. Slots are found
+  ** back from their index through a table of pages; pages are aligned on
+  ** their size, so a slot finds its page, and its index, from its address.
+  ** A lock is only taken to add a page when the stack is empty.
+  */
+  class ConcurrentFrameAllocator
+  {
+  private:
+    typedef struct s_concurrent_page {
+      std::uint64_t index;
+    } t_concurrent_page;
+
+    /* Free slots only: the index of the next one, plus one (0 ends the stack) */
+    typedef struct s_concurrent_slot {
+      std::atomic<std::uint32_t> next;
+    } t_concurrent_slot;
+
+    void *_systemAlloc(std::uint64_t const);
+    void  _systemFree(void *, std::uint64_t const);
+
+    void  _pageAlloc(std::uint64_t const);
+
+    t_concurrent_slot *_slot(std::uint32_t const) const;
+
+    void  _push(std::uint32_t const, std::uint32_t const);
+
+    std::uint64_t _headerPageSize;
+    std::uint64_t _pageSize;
+    std::uint64_t _slotSize;
+    std::uint64_t _slotAlign;
+    std::uint64_t _slotsPerPage;
+    std::uint64_t _maxPages;
+
+    PageProvider *_provider;
+
+    std::mutex _pagesMutex;
+    std::atomic<std::uint64_t> _pageCount;
+    std::atomic<char *> *_pages;
+
+    /* Tag in the high half, index of the first free slot plus one in the low half */
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> _head;
+
+  public:
+    ConcurrentFrameAllocator(std::uint64_t = DEFAULT_PAGE_SIZE, std::uint64_t = DEFAULT_FRAME_SLOT_SIZE, PageProvider * = nullptr, std::uint64_t = DEFAULT_CONCURRENT_FRAME_MAX_PAGES);
+    ~ConcurrentFrameAllocator();
+
+    ConcurrentFrameAllocator(ConcurrentFrameAllocator const &) = delete;
+    void operator=(ConcurrentFrameAllocator const &) = delete;
+
+    void *allocate(std::uint64_t const);
+    void *allocate(std::uint64_t const, std::uint64_t const);
+    void free(void *);
+
+    std::uint64_t getPageCount() const;
+  };
+};
\ No newline at end of file
@@ -0,0 +1,82 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include "Ek/Memory/Memory.hpp"
+#include "Ek/Memory/PageProvider.hpp"
+
+namespace ek
+{
+  /*
+  ** Two bump-pointer arenas: one for the frame being built, one for the
+  ** previous frame. Blocks have no header and are never freed one by one;
+  ** swap() at each frame boundary resets the oldest arena and builds on it.
+  ** Data allocated in frame N stays valid until the end of frame N + 1.
+  */
+  class DoubleFrameArena
+  {
+  private:
+    typedef struct s_arena_page {
+      struct s_arena_page *next;
+      std::uint64_t size;
+    } t_arena_page;
+
+    typedef struct s_arena {
+      t_arena_page *first;
+      t_arena_page *current;
+      char *top;
+      char *end;
+    } t_arena;
+
+    void *_systemAlloc(std::uint64_t const);
+    void  _systemFree(void *, std::uint64_t const);
+
+    void *_pageAlloc(std::uint64_t const, std::uint64_t const);
+
+    void  _reset(t_arena *);
+    void  _release(t_arena *);
+
+    std::uint64_t _pageSize;
+    std::uint64_t _pageHeaderSize;
+
+    PageProvider *_provider;
+
+    t_arena _arenas[2];
+    t_arena *_current;
+
+  public:
+    DoubleFrameArena(std::uint64_t = DEFAULT_PAGE_SIZE, PageProvider * = nullptr);
+    ~DoubleFrameArena();
+
+    DoubleFrameArena(DoubleFrameArena const &) = delete;
+    void operator=(DoubleFrameArena const &) = delete;
+
+    void *allocate(std::uint64_t const);
+    void *allocate(std::uint64_t const, std::uint64_t const);
+    void free(void *);
+
+    void swap();
+    void reset();
+  };
+};
\ No newline at end of file
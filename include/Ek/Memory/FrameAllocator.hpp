@@ -24,6 +24,10 @@
 #pragma once
 
 #include "Ek/Memory/Memory.hpp"
+#include "Ek/Memory/PageProvider.hpp"
+
+/* Trim threshold of a frame allocator never trimmed by itself */
+#define FRAME_TRIM_DISABLED 0xFFFFFFFFFFFFFFFF
 
 namespace ek
 {
@@ -37,31 +41,59 @@ namespace ek
 
     typedef struct s_frame_page {
       struct s_frame_page *next;
+      std::uint64_t liveSlots;
+      bool released;
     } t_frame_page;
 
     void *_systemAlloc(std::uint64_t const);
-    void  _systemFree(void *);
+    void  _systemFree(void *, std::uint64_t const);
 
     void  _pageAlloc();
 
+    t_frame_page *_page(void *) const;
+    void  _pageRelease(std::uint64_t const);
+
     void *_slotAlloc();
+    void  _slotAllocN(std::uint64_t const, void **);
 
     std::uint64_t _headerPageSize;
     std::uint64_t _headerSlotSize;
     std::uint64_t _pageSize;
     std::uint64_t _slotSize;
+    std::uint64_t _slotAlign;
+
+    PageProvider *_provider;
+    std::uint64_t _pageCount;
+    std::uint64_t _emptyPageCount;
+    std::uint64_t _trimThreshold;
 
     t_frame_page *_currentPage;
     t_frame_slot *_currentSlot;
 
   public:
-    FrameAllocator(std::uint64_t = DEFAULT_PAGE_SIZE, std::uint64_t = DEFAULT_FRAME_SLOT_SIZE);
+    FrameAllocator(std::uint64_t = DEFAULT_PAGE_SIZE, std::uint64_t = DEFAULT_FRAME_SLOT_SIZE, PageProvider * = nullptr);
     ~FrameAllocator();
 
     FrameAllocator(FrameAllocator const &) = delete;
     void operator=(FrameAllocator const &) = delete;
 
-    void *allocate(std::uint64_t const) throw();
+    void *allocate(std::uint64_t const);
+    void *allocate(std::uint64_t const, std::uint64_t const);
     void free(void *);
+
+    /* Pages currently held */
+    std::uint64_t getPageCount() const;
+    std::uint64_t getEmptyPageCount() const;
+
+    /* Gives pages without live slots back, but the given number of them */
+    void trim(std::uint64_t const = 0);
+
+    /* Past this number of empty pages, a free() trims down to half of it */
+    void setTrimThreshold(std::uint64_t const);
+
+    /* Batch versions: the slots are carved from the current runs in one step */
+    void allocateN(std::uint64_t const, std::uint64_t const, void **);
+    void allocateN(std::uint64_t const, std::uint64_t const, std::uint64_t const, void **);
+    void freeN(void * const *, std::uint64_t const);
   };
 };
\ No newline at end of file
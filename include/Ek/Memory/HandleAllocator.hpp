@@ -0,0 +1,113 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <chrono>
+
+#include "Ek/Memory/Memory.hpp"
+
+/* 1 Mb */
+#define DEFAULT_HANDLE_HEAP_SIZE 1048576
+
+/* Default number of live handles */
+#define DEFAULT_HANDLE_COUNT 4096
+
+namespace ek
+{
+  /*
+  ** Blocks are reached through handles instead of pointers, so they can be moved.
+  ** Blocks are bumped on a single heap; a freed block leaves a hole that
+  ** defragment() fills by sliding the next live blocks down, a few at a time,
+  ** within a time budget. The whole heap is only compacted at once when full.
+  ** Stored data must be movable with memmove (no self or inner pointers).
+  */
+  class HandleAllocator
+  {
+  private:
+    typedef struct s_handle_block {
+      std::uint64_t size;
+      std::uint32_t index;
+      std::uint32_t free;
+    } t_handle_block;
+
+    typedef struct s_handle_entry {
+      std::uint64_t offset;
+      std::uint32_t generation;
+      std::uint32_t nextFree;
+    } t_handle_entry;
+
+    t_handle_entry *_entry(std::uint32_t const, std::uint32_t const) const;
+
+    bool _compactStep();
+
+    std::uint64_t _capacity;
+    std::uint64_t _headerSize;
+    std::uint32_t _maxHandles;
+
+    char *_heap;
+    std::uint64_t _top;
+    std::uint64_t _freeSize;
+
+    /* Compaction pass: blocks under _compactWrite are packed, blocks from _compactRead are untouched */
+    std::uint64_t _compactRead;
+    std::uint64_t _compactWrite;
+
+    t_handle_entry *_entries;
+    std::uint32_t _firstFreeEntry;
+
+  public:
+    /* Generation 0 is never used: a zeroed handle is null */
+    struct Handle
+    {
+      std::uint32_t index;
+      std::uint32_t generation;
+    };
+
+    HandleAllocator(std::uint64_t = DEFAULT_HANDLE_HEAP_SIZE, std::uint32_t = DEFAULT_HANDLE_COUNT);
+    ~HandleAllocator();
+
+    HandleAllocator(HandleAllocator const &) = delete;
+    void operator=(HandleAllocator const &) = delete;
+
+    Handle allocate(std::uint64_t const);
+    void free(Handle const);
+
+    /* Current address of a block, nullptr for a stale handle; valid until the next allocate() or defragment() */
+    void *get(Handle const) const;
+    bool isValid(Handle const) const;
+
+    template <typename T>
+    T *get(Handle const handle) const
+    {
+      return ((T *) this->get(handle));
+    }
+
+    /* Moves blocks until the heap is compact or the budget is spent; true once compact */
+    bool defragment(std::chrono::nanoseconds const);
+
+    std::uint64_t getCapacity() const;
+    std::uint64_t getUsedSize() const;
+    std::uint64_t getFreeSize() const;
+  };
+};
\ No newline at end of file
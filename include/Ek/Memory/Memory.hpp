@@ -30,19 +30,75 @@
 #include <new>
 
 /* Wrapper for the new keyword with custom allocator */
-#define ALLOC_NEW(Alloc, Type, ...) (new (Alloc.allocate(sizeof(Type))) Type(__VA_ARGS__));
+#define ALLOC_NEW(Alloc, Type, ...) (new (Alloc.allocate(sizeof(Type), alignof(Type))) Type(__VA_ARGS__));
 
 /* Wrapper for deleting data with custom allocator */
 #define ALLOC_FREE(Alloc, Ptr) (Alloc.free(Ptr))
 
+/* Wrapper for building Count objects at once in Out, with a batch allocator */
+#define ALLOC_NEW_ARRAY(Alloc, Type, Count, Out, ...) (ek::allocNewArray<Type>(Alloc, Count, Out, ##__VA_ARGS__))
+
+/* Wrapper for destroying an object with custom allocator */
+#define ALLOC_DELETE(Alloc, Ptr) (ek::allocDelete(Alloc, Ptr))
+
+/* Wrapper for destroying Count objects at once, with a batch allocator */
+#define ALLOC_DELETE_ARRAY(Alloc, Ptrs, Count) (ek::allocDeleteArray(Alloc, Ptrs, Count))
+
 /* Align Value on Size bytes */
 #define ALIGN(Value, Size) (((Value) + ((Size) - (1))) & ~ ((Size) - (1)))
 
 /* Default size alignment: 8 bytes pointer */
 #define DEFAULT_ALIGN_SIZE 8
 
+/* Biggest alignment allocators are asked for: a system page */
+#define MAX_ALIGN_SIZE 4096
+
+/* Cache line size, used to keep data shared between threads apart */
+#define CACHE_LINE_SIZE 64
+
 /* 64 Kb */
 #define DEFAULT_PAGE_SIZE 65536
 
 /* Default frame slot size */
-#define DEFAULT_FRAME_SLOT_SIZE 64
\ No newline at end of file
+#define DEFAULT_FRAME_SLOT_SIZE 64
+
+/* Default biggest pool allocation size */
+#define DEFAULT_POOL_MAX_SIZE 1024
+
+namespace ek
+{
+  template <typename Type, typename Alloc, typename... Args>
+  void allocNewArray(Alloc &allocator, std::uint64_t const count, Type **out, Args const &... args)
+  {
+    std::uint64_t built = 0;
+
+    allocator.allocateN(sizeof(Type), alignof(Type), count, (void **) out);
+    try
+    {
+      for (; built < count; built++)
+        new (out[built]) Type(args...);
+    }
+    catch (...)
+    {
+      while (built > 0)
+        out[--built]->~Type();
+      allocator.freeN((void * const *) out, count);
+      throw;
+    }
+  }
+
+  template <typename Type, typename Alloc>
+  void allocDelete(Alloc &allocator, Type *ptr)
+  {
+    ptr->~Type();
+    allocator.free(ptr);
+  }
+
+  template <typename Type, typename Alloc>
+  void allocDeleteArray(Alloc &allocator, Type * const *ptrs, std::uint64_t const count)
+  {
+    for (std::uint64_t i = 0; i < count; i++)
+      ptrs[i]->~Type();
+    allocator.freeN((void * const *) ptrs, count);
+  }
+};
\ No newline at end of file
@@ -0,0 +1,69 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <memory_resource>
+
+#include "Ek/Memory/Memory.hpp"
+
+namespace ek
+{
+  /*
+  ** std::pmr::memory_resource on top of an Ek allocator, for std::pmr containers.
+  ** The allocator must serve the sizes asked by the container: a FrameAllocator
+  ** only fits node based containers (list, map, set...) whose nodes fit a slot.
+  */
+  template <typename Alloc>
+  class MemoryResource : public std::pmr::memory_resource
+  {
+  private:
+    Alloc &_allocator;
+
+    void *do_allocate(std::size_t size, std::size_t alignment) override
+    {
+      return (this->_allocator.allocate(size, alignment));
+    }
+
+    void do_deallocate(void *ptr, std::size_t, std::size_t) override
+    {
+      this->_allocator.free(ptr);
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const &other) const noexcept override
+    {
+      return (this == &other);
+    }
+
+  public:
+    MemoryResource(Alloc &allocator) :
+      _allocator(allocator)
+    {
+    }
+
+    Alloc &getAllocator() const
+    {
+      return (this->_allocator);
+    }
+  };
+};
\ No newline at end of file
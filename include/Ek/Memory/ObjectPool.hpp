@@ -0,0 +1,214 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdlib>
+#include <utility>
+
+#include "Ek/Memory/Memory.hpp"
+#include "Ek/Utils/Maths.hpp"
+#include "Ek/Utils/Logger.hpp"
+
+/* Default number of objects of a pool */
+#define DEFAULT_OBJECT_POOL_SIZE 4096
+
+/* End of the free entries list */
+#define OBJECT_POOL_ENTRY_NONE 0xFFFFFFFF
+
+namespace ek
+{
+  /*
+  ** Live objects of type T are kept packed at the start of one array, so
+  ** iterating over them reads contiguous memory. Objects are reached through
+  ** handles (index + generation) to an entry giving their current place.
+  ** Destroying an object moves the last one into its place: T must be movable,
+  ** and pointers to objects are only valid until the next destroy().
+  */
+  template <typename T>
+  class ObjectPool
+  {
+  private:
+    typedef struct s_pool_entry {
+      std::uint32_t dense;
+      std::uint32_t generation;
+      std::uint32_t nextFree;
+    } t_pool_entry;
+
+    std::uint32_t _capacity;
+    std::uint32_t _size;
+
+    /* Live objects, then the entry of each of them */
+    T *_objects;
+    std::uint32_t *_denseEntries;
+
+    t_pool_entry *_entries;
+    std::uint32_t _firstFreeEntry;
+
+    t_pool_entry *_entry(std::uint32_t const index, std::uint32_t const generation) const
+    {
+      if (index >= this->_capacity || this->_entries[index].generation != generation)
+        return (nullptr);
+      return (&this->_entries[index]);
+    }
+
+  public:
+    /* Generation 0 is never used: a zeroed handle is null */
+    struct Handle
+    {
+      std::uint32_t index;
+      std::uint32_t generation;
+    };
+
+    ObjectPool(std::uint32_t capacity = DEFAULT_OBJECT_POOL_SIZE) :
+      _capacity(capacity),
+      _size(0),
+      _firstFreeEntry(0)
+    {
+      DEBUG("ObjectPool: Constructor");
+      this->_objects = (T *) std::aligned_alloc(MAX(alignof(T), DEFAULT_ALIGN_SIZE), ALIGN(sizeof(T) * capacity, MAX(alignof(T), DEFAULT_ALIGN_SIZE)));
+      this->_denseEntries = (std::uint32_t *) std::malloc(sizeof(std::uint32_t) * capacity);
+      this->_entries = (t_pool_entry *) std::malloc(sizeof(t_pool_entry) * capacity);
+      if (this->_objects == nullptr || this->_denseEntries == nullptr || this->_entries == nullptr)
+      {
+        std::free(this->_objects);
+        std::free(this->_denseEntries);
+        std::free(this->_entries);
+        throw std::bad_alloc();
+      }
+      for (std::uint32_t i = 0; i < capacity; i++)
+      {
+        this->_entries[i].dense = 0;
+        this->_entries[i].generation = 1;
+        this->_entries[i].nextFree = (i + 1 < capacity) ? i + 1 : OBJECT_POOL_ENTRY_NONE;
+      }
+    }
+
+    ~ObjectPool()
+    {
+      DEBUG("ObjectPool: Destructor");
+      for (std::uint32_t i = 0; i < this->_size; i++)
+        this->_objects[i].~T();
+      std::free(this->_objects);
+      std::free(this->_denseEntries);
+      std::free(this->_entries);
+    }
+
+    ObjectPool(ObjectPool const &) = delete;
+    void operator=(ObjectPool const &) = delete;
+
+    template <typename... Args>
+    Handle create(Args &&... args)
+    {
+      t_pool_entry *entry;
+      Handle handle;
+
+      if (this->_firstFreeEntry == OBJECT_POOL_ENTRY_NONE)
+      {
+        ERROR("ObjectPool: All the " << this->_capacity << " objects are in use.");
+        throw std::bad_alloc();
+      }
+      handle.index = this->_firstFreeEntry;
+      entry = &this->_entries[handle.index];
+      handle.generation = entry->generation;
+
+      new (&this->_objects[this->_size]) T(std::forward<Args>(args)...);
+      this->_firstFreeEntry = entry->nextFree;
+      entry->dense = this->_size;
+      this->_denseEntries[this->_size] = handle.index;
+      this->_size++;
+      return (handle);
+    }
+
+    void destroy(Handle const handle)
+    {
+      t_pool_entry *entry = this->_entry(handle.index, handle.generation);
+      std::uint32_t last = this->_size - 1;
+
+      if (entry == nullptr)
+      {
+        WARN("ObjectPool: Destroy of a stale handle (" << handle.index << ", " << handle.generation << ")");
+        return;
+      }
+
+      /* The last object fills the hole */
+      if (entry->dense != last)
+      {
+        this->_objects[entry->dense] = std::move(this->_objects[last]);
+        this->_denseEntries[entry->dense] = this->_denseEntries[last];
+        this->_entries[this->_denseEntries[last]].dense = entry->dense;
+      }
+      this->_objects[last].~T();
+      this->_size--;
+
+      /* Old handles to this entry become stale */
+      entry->generation = (entry->generation == 0xFFFFFFFF) ? 1 : entry->generation + 1;
+      entry->nextFree = this->_firstFreeEntry;
+      this->_firstFreeEntry = handle.index;
+    }
+
+    /* nullptr for a stale handle */
+    T *get(Handle const handle) const
+    {
+      t_pool_entry *entry = this->_entry(handle.index, handle.generation);
+
+      if (entry == nullptr)
+        return (nullptr);
+      return (&this->_objects[entry->dense]);
+    }
+
+    bool isValid(Handle const handle) const
+    {
+      return (this->_entry(handle.index, handle.generation) != nullptr);
+    }
+
+    /* Handle of the object at a position of the live objects */
+    Handle getHandle(std::uint32_t const position) const
+    {
+      Handle handle = { this->_denseEntries[position], this->_entries[this->_denseEntries[position]].generation };
+
+      return (handle);
+    }
+
+    std::uint32_t getSize() const
+    {
+      return (this->_size);
+    }
+
+    std::uint32_t getCapacity() const
+    {
+      return (this->_capacity);
+    }
+
+    /* Live objects, packed */
+    T *begin() const
+    {
+      return (this->_objects);
+    }
+
+    T *end() const
+    {
+      return (this->_objects + this->_size);
+    }
+  };
+};
\ No newline at end of file
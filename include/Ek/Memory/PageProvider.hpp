@@ -0,0 +1,100 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "Ek/Memory/Memory.hpp"
+
+/* Ask for transparent huge pages on reserved ranges (madvise(MADV_HUGEPAGE)) */
+#define PAGE_PROVIDER_HUGE_PAGES 0x1
+
+/* Reserve ranges from the huge pages pool (MAP_HUGETLB), falls back to normal pages */
+#define PAGE_PROVIDER_HUGE_TLB 0x2
+
+/* 64 Mb */
+#define DEFAULT_PAGE_RESERVE_SIZE 67108864
+
+/* Default number of freed pages kept ready for reuse */
+#define DEFAULT_PAGE_CACHE_SIZE 16
+
+/* 2 Mb: ranges are aligned on it when huge pages are asked */
+#define HUGE_PAGE_SIZE 2097152
+
+namespace ek
+{
+  /*
+  ** Hands out pages carved from large reserved virtual ranges.
+  ** Every block is aligned on the page size. Freed blocks are kept in a small
+  ** cache for reuse; past the cache size their memory is given back to the
+  ** system but the addresses are kept for later allocations.
+  ** Thread-safe: one provider can feed allocators of different threads.
+  */
+  class PageProvider
+  {
+  private:
+    typedef struct s_page_block {
+      char *ptr;
+      std::uint64_t size;
+    } t_page_block;
+
+    char *_reserve(std::uint64_t const);
+    void  _unreserve(char *, std::uint64_t const);
+    void  _decommit(char *, std::uint64_t const);
+
+    bool _popBlock(std::vector<t_page_block> &, std::uint64_t const, char **);
+
+    std::uint64_t _pageSize;
+    std::uint64_t _reserveSize;
+    std::uint64_t _rangeAlign;
+    std::uint64_t _flags;
+    std::uint64_t _cacheSize;
+    std::uint64_t _cachedSize;
+
+    char *_top;
+    char *_end;
+
+    std::vector<t_page_block> _ranges;
+    std::vector<t_page_block> _cache;
+    std::vector<t_page_block> _decommitted;
+
+    std::mutex _mutex;
+
+  public:
+    PageProvider(std::uint64_t = DEFAULT_PAGE_SIZE, std::uint64_t = DEFAULT_PAGE_RESERVE_SIZE,
+                 std::uint64_t = 0, std::uint64_t = DEFAULT_PAGE_CACHE_SIZE);
+    ~PageProvider();
+
+    PageProvider(PageProvider const &) = delete;
+    void operator=(PageProvider const &) = delete;
+
+    void *allocate(std::uint64_t const);
+    void free(void *, std::uint64_t const);
+
+    std::uint64_t getPageSize() const;
+    std::uint64_t getReservedSize();
+    std::uint64_t getCachedSize();
+  };
+};
\ No newline at end of file
@@ -0,0 +1,89 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include "Ek/Memory/Memory.hpp"
+#include "Ek/Memory/PageProvider.hpp"
+
+/* Biggest slot size a pool can be configured with */
+#define POOL_MAX_SIZE_LIMIT 4096
+
+/* Maximum number of size classes (see PoolAllocator constructor) */
+#define POOL_MAX_CLASSES 48
+
+namespace ek
+{
+  class PoolAllocator
+  {
+  private:
+    typedef struct s_pool_slot {
+      std::uint64_t size;
+      struct s_pool_slot *next;
+    } t_pool_slot;
+
+    typedef struct s_pool_page {
+      struct s_pool_page *next;
+      std::uint64_t classIndex;
+    } t_pool_page;
+
+    typedef struct s_pool_class {
+      std::uint64_t slotSize;
+      std::uint64_t slotCount;
+      t_pool_slot *currentSlot;
+    } t_pool_class;
+
+    void *_systemAlloc(std::uint64_t const);
+    void  _systemFree(void *, std::uint64_t const);
+
+    void  _pageAlloc(std::uint64_t const);
+
+    void *_slotAlloc(t_pool_class *);
+
+    std::uint64_t _headerPageSize;
+    std::uint64_t _pageSize;
+    std::uint64_t _maxSize;
+    std::uint64_t _classCount;
+
+    PageProvider *_provider;
+
+    t_pool_page *_pages;
+    t_pool_class _classes[POOL_MAX_CLASSES];
+
+    /* Size to class lookup table, indexed by (size + 7) / 8 */
+    std::uint8_t _lookup[(POOL_MAX_SIZE_LIMIT / DEFAULT_ALIGN_SIZE) + 1];
+
+  public:
+    PoolAllocator(std::uint64_t = DEFAULT_PAGE_SIZE, std::uint64_t = DEFAULT_POOL_MAX_SIZE, PageProvider * = nullptr);
+    ~PoolAllocator();
+
+    PoolAllocator(PoolAllocator const &) = delete;
+    void operator=(PoolAllocator const &) = delete;
+
+    void *allocate(std::uint64_t const);
+    void *allocate(std::uint64_t const, std::uint64_t const);
+    void free(void *);
+
+    std::uint64_t getMaxSize() const;
+  };
+};
\ No newline at end of file
@@ -0,0 +1,126 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include "Ek/Memory/Memory.hpp"
+#include "Ek/Memory/AllocatorStats.hpp"
+
+/* Set once for ek-memory and the targets linked to it by the EK_MEMORY_TRACKING option: the class layout depends on it */
+#ifndef EK_MEMORY_TRACKING
+  #error "EK_MEMORY_TRACKING is not defined: link to ek-memory, or define it to the value ek-memory was built with"
+#endif
+
+/* Bytes taken from the inner allocator in front of each tracked block, when aligned on 16 bytes at most */
+#define PROXY_HEADER_SIZE 16
+
+namespace ek
+{
+  /*
+  ** Wraps an allocator and tracks its usage under a name.
+  ** Without EK_MEMORY_TRACKING, every call goes straight to the wrapped allocator.
+  ** With it, each block is stored after a header in the inner block, which must
+  ** hold PROXY_HEADER_SIZE more bytes (the alignment, when it is bigger): a
+  ** FrameAllocator of 64-byte slots serves blocks of 48 bytes through a proxy.
+  */
+  template <typename Inner>
+  class ProxyAllocator
+  {
+  private:
+    Inner &_inner;
+
+#if EK_MEMORY_TRACKING
+    /* Stored right before each block; offset is the distance to the inner block */
+    typedef struct s_proxy_block {
+      std::uint64_t size;
+      std::uint64_t offset;
+    } t_proxy_block;
+
+    std::uint64_t _headerSize;
+    AllocatorStats _stats;
+#endif
+
+  public:
+    ProxyAllocator(std::string const &name, Inner &inner) :
+      _inner(inner)
+#if EK_MEMORY_TRACKING
+      , _headerSize(PROXY_HEADER_SIZE)
+      , _stats(name)
+#endif
+    {
+#if !EK_MEMORY_TRACKING
+      (void) name;
+#endif
+    }
+
+    ProxyAllocator(ProxyAllocator const &) = delete;
+    void operator=(ProxyAllocator const &) = delete;
+
+#if EK_MEMORY_TRACKING
+    void *allocate(std::uint64_t const size)
+    {
+      return (this->allocate(size, DEFAULT_ALIGN_SIZE));
+    }
+
+    void *allocate(std::uint64_t const size, std::uint64_t const alignment)
+    {
+      std::uint64_t offset = (alignment > this->_headerSize) ? alignment : this->_headerSize;
+      char *ptr = ((char *) this->_inner.allocate(size + offset, alignment)) + offset;
+      t_proxy_block *block = ((t_proxy_block *) ptr) - 1;
+
+      block->size = size;
+      block->offset = offset;
+      this->_stats.onAllocate(size);
+      return (ptr);
+    }
+
+    void free(void *ptr)
+    {
+      t_proxy_block *block = ((t_proxy_block *) ptr) - 1;
+
+      this->_stats.onFree(block->size);
+      this->_inner.free(((char *) ptr) - block->offset);
+    }
+
+    AllocatorStats const &getStats() const
+    {
+      return (this->_stats);
+    }
+#else
+    void *allocate(std::uint64_t const size)
+    {
+      return (this->_inner.allocate(size));
+    }
+
+    void *allocate(std::uint64_t const size, std::uint64_t const alignment)
+    {
+      return (this->_inner.allocate(size, alignment));
+    }
+
+    void free(void *ptr)
+    {
+      this->_inner.free(ptr);
+    }
+#endif
+  };
+};
\ No newline at end of file
@@ -0,0 +1,112 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstddef>
+
+#include "Ek/Memory/Memory.hpp"
+#include "Ek/Memory/StackAllocator.hpp"
+
+/* Default inline buffer size: 1 Kb */
+#define DEFAULT_SCRATCH_SIZE 1024
+
+namespace ek
+{
+  /*
+  ** Temporary allocator with an inline buffer of Size bytes, meant to live
+  ** on the call stack. Blocks are bumped on the buffer and never freed one by
+  ** one; once the buffer is full, blocks come from the parent stack allocator
+  ** and are all given back to it when the scratch allocator is destroyed.
+  */
+  template <std::uint64_t Size = DEFAULT_SCRATCH_SIZE>
+  class ScratchAllocator
+  {
+  private:
+    alignas(std::max_align_t) char _buffer[Size];
+    std::uint64_t _top;
+
+    StackAllocator &_parent;
+    StackAllocator::Marker _marker;
+    bool _spilled;
+
+  public:
+    ScratchAllocator(StackAllocator &parent) :
+      _top(0),
+      _parent(parent),
+      _spilled(false)
+    {
+    }
+
+    ~ScratchAllocator()
+    {
+      this->reset();
+    }
+
+    ScratchAllocator(ScratchAllocator const &) = delete;
+    void operator=(ScratchAllocator const &) = delete;
+
+    void *allocate(std::uint64_t const size)
+    {
+      return (this->allocate(size, DEFAULT_ALIGN_SIZE));
+    }
+
+    void *allocate(std::uint64_t const size, std::uint64_t const alignment)
+    {
+      std::uint64_t offset = ALIGN(((std::uintptr_t) this->_buffer) + this->_top, alignment) - ((std::uintptr_t) this->_buffer);
+
+      if (offset + size <= Size)
+      {
+        this->_top = offset + size;
+        return (this->_buffer + offset);
+      }
+
+      /* The marker is only taken on the first spill: it stays above any use of the parent before it */
+      if (!this->_spilled)
+      {
+        this->_marker = this->_parent.getMarker();
+        this->_spilled = true;
+      }
+      return (this->_parent.allocate(size, alignment));
+    }
+
+    /* Blocks are only given back by reset(), spilled ones included: freeing one from the parent could pop it below the marker */
+    void free(void *)
+    {
+    }
+
+    /* Frees every block at once */
+    void reset()
+    {
+      this->_top = 0;
+      if (this->_spilled)
+        this->_parent.freeToMarker(this->_marker);
+      this->_spilled = false;
+    }
+
+    bool hasSpilled() const
+    {
+      return (this->_spilled);
+    }
+  };
+};
\ No newline at end of file
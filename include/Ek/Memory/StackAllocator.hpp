@@ -24,6 +24,7 @@
 #pragma once
 
 #include "Ek/Memory/Memory.hpp"
+#include "Ek/Memory/PageProvider.hpp"
 
 namespace ek
 {
@@ -43,28 +44,61 @@ namespace ek
     } t_stack_page;
 
     void *_systemAlloc(std::uint64_t const);
-    void  _systemFree(void *);
+    void  _systemFree(void *, std::uint64_t const);
 
-    void  _pageAlloc(std::uint64_t const) throw();
+    void  _pageAlloc(std::uint64_t const);
     void  _pageFree();
 
-    void *_slotAlloc(std::uint64_t const) throw();
+    void *_slotAlloc(std::uint64_t const, std::uint64_t const);
     void  _slotFree(t_stack_slot *);
 
     std::uint64_t _pageSize;
     std::uint64_t _pageHeaderSize;
     std::uint64_t _slotHeaderSize;
 
+    PageProvider *_provider;
+    std::uint64_t _pageCount;
+
     t_stack_page *_currentPage;
 
   public:
-    StackAllocator(std::uint64_t = DEFAULT_PAGE_SIZE);
+    /* Saved top of the stack, valid as long as the stack does not go below it */
+    struct Marker
+    {
+      t_stack_page *page;
+      t_stack_slot *top;
+      t_stack_slot *last;
+    };
+
+    StackAllocator(std::uint64_t = DEFAULT_PAGE_SIZE, PageProvider * = nullptr);
     ~StackAllocator();
 
     StackAllocator(StackAllocator const &) = delete;
     void operator=(StackAllocator const &) = delete;
 
-    void *allocate(std::uint64_t const) throw();
+    void *allocate(std::uint64_t const);
+    void *allocate(std::uint64_t const, std::uint64_t const);
     void free(void *);
+
+    /* Pages currently held, spare ones included */
+    std::uint64_t getPageCount() const;
+
+    Marker getMarker() const;
+    void freeToMarker(Marker const &);
+  };
+
+  /* Frees everything allocated in its lifetime at once */
+  class StackScope
+  {
+  private:
+    StackAllocator &_allocator;
+    StackAllocator::Marker _marker;
+
+  public:
+    StackScope(StackAllocator &);
+    ~StackScope();
+
+    StackScope(StackScope const &) = delete;
+    void operator=(StackScope const &) = delete;
   };
 };
\ No newline at end of file
@@ -0,0 +1,86 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+#include "Ek/Memory/Memory.hpp"
+
+namespace ek
+{
+  /*
+  ** Standard allocator on top of an Ek allocator, for std containers.
+  ** Copies and rebinds share the same Ek allocator.
+  */
+  template <typename T, typename Alloc>
+  class StlAllocator
+  {
+  private:
+    Alloc *_allocator;
+
+  public:
+    typedef T value_type;
+
+    StlAllocator(Alloc &allocator) noexcept :
+      _allocator(&allocator)
+    {
+    }
+
+    template <typename U>
+    StlAllocator(StlAllocator<U, Alloc> const &other) noexcept :
+      _allocator(&other.getAllocator())
+    {
+    }
+
+    T *allocate(std::size_t const count)
+    {
+      if (count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        throw std::bad_alloc();
+      return ((T *) this->_allocator->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *ptr, std::size_t const)
+    {
+      this->_allocator->free(ptr);
+    }
+
+    Alloc &getAllocator() const
+    {
+      return (*this->_allocator);
+    }
+
+    template <typename U>
+    bool operator==(StlAllocator<U, Alloc> const &other) const
+    {
+      return (this->_allocator == &other.getAllocator());
+    }
+
+    template <typename U>
+    bool operator!=(StlAllocator<U, Alloc> const &other) const
+    {
+      return (this->_allocator != &other.getAllocator());
+    }
+  };
+};
\ No newline at end of file
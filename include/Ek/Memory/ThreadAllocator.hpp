@@ -0,0 +1,95 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "Ek/Memory/Memory.hpp"
+
+namespace ek
+{
+  /*
+  ** One instance of Alloc per thread, created on the first call to local().
+  ** A block freed by another thread than its owner is pushed on the owner's
+  ** remote free list, which is drained by the owner on its next allocate().
+  ** Instances of exited threads are kept and adopted by new threads.
+  ** Once a thread has released its instance, while its thread_local objects
+  ** are destroyed, it is exiting: local() must not be called anymore, as it
+  ** would take an instance that is never released, and its frees go remote.
+  */
+  template <typename Alloc>
+  class ThreadAllocator
+  {
+  private:
+    /*
+    ** The word before each block holds its owner. Over-aligned blocks set
+    ** THREAD_BLOCK_PADDED in it and keep the inner block address one word lower.
+    ** Once remotely freed, the inner block links to the next one.
+    */
+    typedef struct s_thread_block {
+      struct s_thread_block *next;
+    } t_thread_block;
+
+    typedef struct s_thread_local {
+      ThreadAllocator *instance;
+      bool exiting;
+      ~s_thread_local();
+    } t_thread_local;
+
+    ThreadAllocator();
+    ~ThreadAllocator();
+
+    static ThreadAllocator *_acquire();
+    static void _release(ThreadAllocator *);
+
+    void _remoteFree(t_thread_block *);
+    void _drain();
+
+    Alloc _allocator;
+    std::uint64_t _headerSize;
+
+    bool _abandoned;
+    ThreadAllocator *_nextInstance;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<t_thread_block *> _remoteBlocks;
+
+    static std::mutex _instancesMutex;
+    static ThreadAllocator *_instances;
+    static thread_local t_thread_local _local;
+
+  public:
+    ThreadAllocator(ThreadAllocator const &) = delete;
+    void operator=(ThreadAllocator const &) = delete;
+
+    static ThreadAllocator &local();
+    static bool isExiting();
+
+    void *allocate(std::uint64_t const);
+    void *allocate(std::uint64_t const, std::uint64_t const);
+
+    /* Any thread, exiting ones included, can free a block: it does not need its own instance */
+    static void free(void *);
+  };
+};
\ No newline at end of file
@@ -0,0 +1,71 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "Ek/Utils/Config.hpp"
+
+#ifndef __linux__
+  #include <condition_variable>
+  #include <mutex>
+#endif
+
+namespace ek
+{
+  /*
+  ** Puts threads to sleep until an event, without missing the events raised
+  ** between the check of a condition and the sleep:
+  **   key = prepareWait(); if (condition) cancelWait(); else wait(key);
+  ** Waiters sleep on a futex under Linux. Notifying costs a fence and a load
+  ** while nobody waits.
+  */
+  class EventCount
+  {
+  private:
+    std::atomic<std::uint32_t> _epoch;
+    std::atomic<std::uint32_t> _waiters;
+
+#ifndef __linux__
+    std::mutex _mutex;
+    std::condition_variable _condition;
+#endif
+
+    void  _notify(bool const);
+
+  public:
+    EventCount();
+
+    EventCount(EventCount const &) = delete;
+    void operator=(EventCount const &) = delete;
+
+    std::uint32_t prepareWait();
+    void cancelWait();
+    void wait(std::uint32_t const);
+
+    void notifyOne();
+    void notifyAll();
+  };
+};
\ No newline at end of file
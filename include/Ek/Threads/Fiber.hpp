@@ -0,0 +1,70 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <cstdint>
+
+#include "Ek/Utils/Config.hpp"
+
+/* Context switches are written for the System V x86-64 ABI */
+#if defined(EK_SYSTEM_UNIX) && defined(__linux__) && defined(__x86_64__)
+  #define EK_FIBERS
+#endif
+
+/* Initial floating point state of a fiber: masked exceptions, round to nearest */
+#define FIBER_DEFAULT_MXCSR 0x1F80
+#define FIBER_DEFAULT_FPU_CONTROL 0x037F
+
+namespace ek
+{
+  /*
+  ** Execution context with its own stack.
+  ** A fiber only saves what the ABI asks a callee to keep: the stack pointer,
+  ** six registers and the floating point control words, so a switch costs
+  ** a few dozen instructions and no system call.
+  ** A default built fiber stands for the thread calling switchTo(): its
+  ** context is saved there, to be switched back to later.
+  ** Fibers never return: the entry function switches away once done.
+  */
+  class Fiber
+  {
+  private:
+    void *_stackPointer;
+#ifdef __SANITIZE_THREAD__
+    void *_tsanFiber;
+    bool _ownsTsanFiber;
+#endif
+
+  public:
+    Fiber();
+    Fiber(void *, std::uint64_t const, void (*)(void *), void *);
+    ~Fiber();
+
+    Fiber(Fiber const &) = delete;
+    void operator=(Fiber const &) = delete;
+
+    /* Saves the running context in from, and resumes to */
+    static void switchTo(Fiber &, Fiber &);
+  };
+};
\ No newline at end of file
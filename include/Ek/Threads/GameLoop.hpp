@@ -0,0 +1,141 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "Ek/Threads/StateBuffer.hpp"
+#include "Ek/Threads/ThreadManager.hpp"
+#include "Ek/Utils/Logger.hpp"
+
+/* Most ticks run in a row to catch up, the rest of the delay is dropped */
+#define GAME_LOOP_MAX_CATCH_UP 5
+
+namespace ek
+{
+  /*
+  ** Fixed timestep loop of the game thread.
+  ** Each tick starts from a copy of the last state, is updated with the
+  ** tick duration, then published: the main thread renders at its own rate
+  ** without any lock. A late game thread runs several ticks in a row, up to
+  ** GAME_LOOP_MAX_CATCH_UP, so the simulation keeps the same steps.
+  ** Rendering runs one tick behind the game: between the two latest states
+  ** taken, with getAlpha() as the interpolation factor.
+  */
+  template <typename T, std::uint32_t Count = 4>
+  class GameLoop
+  {
+  private:
+    typedef std::chrono::steady_clock t_clock;
+
+    StateBuffer<T, Count> _states;
+    std::chrono::nanoseconds _tickDuration;
+
+    static std::int64_t _now()
+    {
+      return (std::chrono::duration_cast<std::chrono::nanoseconds>(t_clock::now().time_since_epoch()).count());
+    }
+
+  public:
+    GameLoop(std::chrono::nanoseconds const tickDuration, T const &initial = T()) :
+      _states(initial),
+      _tickDuration(tickDuration)
+    {
+    }
+
+    GameLoop(GameLoop const &) = delete;
+    void operator=(GameLoop const &) = delete;
+
+    /* Game thread: one tick, update(state, seconds) standing for the given time */
+    template <typename F>
+    void tick(F &&update, std::int64_t const time)
+    {
+      T &next = this->_states.getNext();
+
+      next = this->_states.getLast();
+      update(next, std::chrono::duration<float>(this->_tickDuration).count());
+      this->_states.publish(time);
+    }
+
+    /* Game thread: ticks until the thread manager stops */
+    template <typename F>
+    void run(ThreadManager &threads, F &&update)
+    {
+      std::int64_t duration = this->_tickDuration.count();
+      std::int64_t next = _now() + duration;
+      std::int64_t now;
+      std::uint32_t ticks;
+
+      while (threads.sleepFor(std::chrono::nanoseconds(next - _now())))
+      {
+        now = _now();
+        for (ticks = 0; next <= now && ticks < GAME_LOOP_MAX_CATCH_UP; ticks++)
+        {
+          this->tick(update, next);
+          next += duration;
+        }
+
+        /* Too late to catch up: the game slows down instead of falling further behind */
+        if (next <= now)
+        {
+          WARN("GameLoop: " << (now - next) / duration + 1 << " ticks dropped");
+          next = now + duration;
+        }
+      }
+    }
+
+    /* Main thread: takes the latest state, false when there is none since the last call */
+    bool update()
+    {
+      return (this->_states.update());
+    }
+
+    T const &getLatest() const
+    {
+      return (this->_states.getLatest());
+    }
+
+    T const &getPrevious() const
+    {
+      return (this->_states.getPrevious());
+    }
+
+    std::uint64_t getTick() const
+    {
+      return (this->_states.getLatestTick());
+    }
+
+    /* Main thread: interpolation factor from the previous to the latest state, now */
+    float getAlpha() const
+    {
+      return (this->_states.getAlpha(_now() - this->_tickDuration.count()));
+    }
+
+    std::chrono::nanoseconds getTickDuration() const
+    {
+      return (this->_tickDuration);
+    }
+  };
+};
\ No newline at end of file
@@ -0,0 +1,66 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/* Size of a job, taken from the job allocator */
+#define JOB_SIZE 128
+
+/* Room left to the job function and its captures */
+#define JOB_HEADER_SIZE 48
+#define JOB_DATA_ALIGN 16
+#define JOB_DATA_SIZE (JOB_SIZE - JOB_HEADER_SIZE)
+
+namespace ek
+{
+  class JobCounter;
+  class JobManager;
+  struct s_job_fiber;
+
+  /* Runs the function stored in data, then destroys it */
+  typedef struct s_job {
+    void (*execute)(struct s_job *);
+    /* Decremented once the job is done */
+    JobCounter *counter;
+    /* Counters to wait for before the job is queued, plus one while they are set */
+    std::atomic<std::uint32_t> dependencies;
+    /* Set on the job resuming a waiting fiber, which runs no function */
+    struct s_job_fiber *fiber;
+    /* Manager which allocated the job, and which it is freed to */
+    JobManager *manager;
+    alignas(JOB_DATA_ALIGN) char data[JOB_DATA_SIZE];
+  } t_job;
+
+  /* A job waiting for a counter */
+  typedef struct s_job_waiter {
+    t_job *job;
+    /* Manager which allocated the waiter */
+    JobManager *manager;
+    struct s_job_waiter *next;
+  } t_job_waiter;
+
+  static_assert(sizeof(t_job) == JOB_SIZE, "Job: unexpected padding");
+};
\ No newline at end of file
@@ -0,0 +1,71 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "Ek/Memory/Memory.hpp"
+#include "Ek/Threads/Job.hpp"
+
+namespace ek
+{
+  /*
+  ** Number of jobs of a group still to run.
+  ** Jobs added with a counter increment it, and decrement it once done.
+  ** Jobs added after a counter wait in its list, and are queued when it
+  ** reaches zero. A counter must outlive the jobs using it.
+  */
+  class JobCounter
+  {
+  private:
+    friend class JobManager;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> _value;
+    std::atomic<t_job_waiter *> _waiters;
+    /* Jobs still touching the counter once done: it is not done before they leave */
+    std::atomic<std::uint32_t> _releasing;
+
+  public:
+    JobCounter() :
+      _value(0),
+      _waiters(nullptr),
+      _releasing(0)
+    {
+    }
+
+    JobCounter(JobCounter const &) = delete;
+    void operator=(JobCounter const &) = delete;
+
+    std::uint64_t getValue() const
+    {
+      return (this->_value.load(std::memory_order_acquire));
+    }
+
+    bool isDone() const
+    {
+      return (this->getValue() == 0 && this->_releasing.load(std::memory_order_acquire) == 0);
+    }
+  };
+};
\ No newline at end of file
@@ -0,0 +1,232 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Ek/Memory/ConcurrentFrameAllocator.hpp"
+#include "Ek/Memory/PageProvider.hpp"
+#include "Ek/Threads/EventCount.hpp"
+#include "Ek/Threads/Fiber.hpp"
+#include "Ek/Threads/Job.hpp"
+#include "Ek/Threads/JobCounter.hpp"
+#include "Ek/Threads/JobQueue.hpp"
+#include "Ek/Threads/ThreadManager.hpp"
+
+/* Fewest workers, whatever the number of cores */
+#define JOB_MIN_WORKERS 2
+
+/* Biggest number of queues: one per worker, plus one per thread adding jobs */
+#define JOB_MAX_QUEUES 64
+
+/* Failed searches of a worker before it sleeps */
+#define JOB_SPIN_COUNT 64
+
+/* Memory of a fiber: its guard page, its stack, and its record at the top */
+#define JOB_FIBER_STACK_SIZE 65536
+#define JOB_FIBER_GUARD_SIZE 4096
+
+/* Managers a thread finds without a lock, the others are looked up again */
+#define JOB_THREAD_SLOTS 4
+
+/* Free fibers kept by each worker, beside the shared list */
+#define JOB_FIBER_CACHE_SIZE 8
+
+namespace ek
+{
+  class JobManager;
+
+  /* Fiber of the pool, its record lying at the top of its stack */
+  typedef struct s_job_fiber {
+    Fiber context;
+    /* Queued once the counter the fiber waits for reaches zero */
+    t_job resume;
+    t_job *job;
+    JobManager *manager;
+    /* Resumed by its thread once the running fiber leaves */
+    struct s_job_fiber *next;
+  } t_job_fiber;
+
+  /*
+  ** Pool of worker threads running jobs, one per core beside the calling
+  ** thread by default.
+  ** Each thread adding jobs owns a queue and pushes on it without any lock;
+  ** a job run by a worker adds its own jobs on the queue of the worker.
+  ** Idle workers steal from the queues of others, starting from a random
+  ** one, then sleep until a job is added.
+  ** Jobs, with the function they run, are taken from a concurrent frame
+  ** allocator: adding a job does not touch the heap. When its queue is full,
+  ** a job is run right away by the thread adding it.
+  ** Jobs form a graph through counters: a job may signal a counter once
+  ** done, and wait for counters before being queued.
+  ** In fiber mode, every job runs on a fiber from a pool made at startup.
+  ** A job waiting for a counter leaves its fiber parked on the counter, and
+  ** the thread goes on with other jobs; the fiber is queued again, and may
+  ** resume on another thread, once the counter reaches zero. When every
+  ** fiber is taken, jobs run on the thread stack and wait by running others.
+  */
+  class JobManager
+  {
+  private:
+    /* State of a thread using the manager, kept by the manager */
+    typedef struct s_job_thread {
+      std::thread::id owner;
+      JobQueue *queue;
+      std::uint32_t random;
+      bool worker;
+      /* Jobs running on the thread stack, to catch wait() called from one */
+      std::uint32_t depth;
+      /* Context of the thread itself, left while one of its fibers runs */
+      Fiber context;
+      t_job_fiber *fiber;
+      /* Set by a fiber leaving the thread to wait */
+      JobCounter *waitCounter;
+      t_job_fiber *resumable;
+      t_job_fiber *fibers[JOB_FIBER_CACHE_SIZE];
+      std::uint32_t fiberCount;
+    } t_job_thread;
+
+    /* A thread using several managers has a state in each */
+    typedef struct s_job_thread_slot {
+      std::uint64_t manager;
+      t_job_thread *thread;
+    } t_job_thread_slot;
+
+    template <typename F>
+    t_job *_makeJob(F &&function, JobCounter *counter)
+    {
+      typedef typename std::decay<F>::type t_function;
+
+      static_assert(sizeof(t_function) <= JOB_DATA_SIZE, "JobManager: job function too big");
+      static_assert(alignof(t_function) <= JOB_DATA_ALIGN, "JobManager: job function over-aligned");
+
+      t_job *job = this->_allocJob(counter);
+
+      new (job->data) t_function(std::forward<F>(function));
+      job->execute = [](t_job *job) {
+        t_function *function = (t_function *) job->data;
+
+        (*function)();
+        function->~t_function();
+      };
+      return (job);
+    }
+
+    t_job *_allocJob(JobCounter *);
+    void  _submit(t_job *);
+    void  _execute(t_job *);
+
+    void  _run(t_job_thread &, t_job *);
+
+    void  _depend(t_job *, std::initializer_list<JobCounter *> const &);
+    void  _resolve(t_job *);
+    void  _release(JobCounter *);
+
+    t_job_thread &_local();
+    t_job_thread *_register(std::thread::id const);
+
+    t_job *_findJob(t_job_thread &);
+    t_job *_steal(t_job_thread &);
+
+    void  _createFibers(std::uint32_t const);
+    t_job_fiber *_acquireFiber(t_job_thread &);
+    void  _releaseFiber(t_job_thread &, t_job_fiber *);
+    void  _suspend(JobCounter &);
+    static void _runFiber(void *);
+
+    void  _work(std::uint32_t const);
+
+    static std::atomic<std::uint64_t> _nextId;
+    static thread_local t_job_thread_slot _slots[JOB_THREAD_SLOTS];
+    static thread_local std::uint32_t _nextSlot;
+
+    std::uint64_t _id;
+    std::uint64_t _affinity;
+    ConcurrentFrameAllocator _jobAllocator;
+    ConcurrentFrameAllocator _waiterAllocator;
+
+    std::mutex _queuesMutex;
+    std::atomic<JobQueue *> _queues[JOB_MAX_QUEUES];
+    std::atomic<std::uint32_t> _queueCount;
+    std::vector<t_job_thread *> _threads;
+
+    std::atomic<bool> _running;
+    EventCount _events;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> _pendingJobs;
+
+    PageProvider _stackProvider;
+    std::vector<t_job_fiber *> _fibers;
+    std::mutex _fibersMutex;
+    std::vector<t_job_fiber *> _freeFibers;
+
+    std::vector<std::thread> _workers;
+
+  public:
+    /*
+    ** Worker count, zero for one per core, fiber count, zero for no fiber,
+    ** and cores of the workers, to keep them off the game and audio threads
+    */
+    JobManager(std::uint32_t = 0, std::uint32_t = 0, std::uint64_t = THREAD_ANY_CORE);
+    ~JobManager();
+
+    JobManager(JobManager const &) = delete;
+    void operator=(JobManager const &) = delete;
+
+    /* Adds a job running a function, from any thread */
+    template <typename F>
+    void run(F &&function, JobCounter *counter = nullptr)
+    {
+      this->_submit(this->_makeJob(std::forward<F>(function), counter));
+    }
+
+    /* Adds a job queued once every dependency reaches zero */
+    template <typename F>
+    void runAfter(std::initializer_list<JobCounter *> dependencies, F &&function, JobCounter *counter = nullptr)
+    {
+      this->_depend(this->_makeJob(std::forward<F>(function), counter), dependencies);
+    }
+
+    void run(void (*)(void *), void *, JobCounter * = nullptr);
+
+    /*
+    ** Runs jobs until every job added is done.
+    ** Not from a job: it would wait for itself, so it returns with an error.
+    */
+    void wait();
+
+    /* Runs jobs until the counter reaches zero, or parks the fiber of the calling job */
+    void wait(JobCounter &);
+
+    std::uint32_t getWorkerCount() const;
+    std::uint32_t getFiberCount() const;
+  };
+};
\ No newline at end of file
@@ -0,0 +1,72 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "Ek/Memory/Memory.hpp"
+#include "Ek/Threads/Job.hpp"
+
+/* Default capacity of a queue, a power of two */
+#define DEFAULT_JOB_QUEUE_SIZE 4096
+
+namespace ek
+{
+  /*
+  ** Work-stealing deque (Chase-Lev) of a thread.
+  ** The owner pushes and pops jobs at the bottom, last in first out, so it
+  ** works on hot data. Other threads steal from the top, oldest job first.
+  ** The owner only races with thieves over the last job. The capacity is
+  ** fixed: push() fails once the queue is full.
+  */
+  class JobQueue
+  {
+  private:
+    alignas(CACHE_LINE_SIZE) std::atomic<std::int64_t> _top;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::int64_t> _bottom;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<t_job *> *_jobs;
+    std::int64_t _size;
+    std::thread::id _owner;
+
+  public:
+    JobQueue(std::uint64_t = DEFAULT_JOB_QUEUE_SIZE);
+    ~JobQueue();
+
+    JobQueue(JobQueue const &) = delete;
+    void operator=(JobQueue const &) = delete;
+
+    /* Owner only */
+    bool push(t_job *);
+    t_job *pop();
+
+    /* Any thread */
+    t_job *steal();
+
+    std::thread::id getOwner() const;
+    void setOwner(std::thread::id const);
+  };
+};
\ No newline at end of file
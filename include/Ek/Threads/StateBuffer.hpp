@@ -0,0 +1,166 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "Ek/Memory/Memory.hpp"
+
+/* Published word: index of the published slot, and whether the reader has not taken it yet */
+#define STATE_BUFFER_INDEX 0x3
+#define STATE_BUFFER_FRESH 0x4
+
+namespace ek
+{
+  /*
+  ** Mutable state shared by one writer (the game thread) and one reader
+  ** (the main thread), without any lock.
+  ** The writer builds the next state in a slot of its own, then publishes
+  ** it: its slot and the published one are exchanged in a single atomic
+  ** operation. The reader takes the published slot the same way, giving
+  ** back one of its own. No side ever waits for the other, and a slot is
+  ** only written while no reader holds it.
+  ** With 4 slots the reader keeps the two latest states it took, to
+  ** interpolate between them; with 3 it only keeps the latest.
+  */
+  template <typename T, std::uint32_t Count = 4>
+  class StateBuffer
+  {
+    static_assert(Count == 3 || Count == 4, "StateBuffer: 3 or 4 slots");
+
+  private:
+    typedef struct s_state_slot {
+      T state;
+      std::uint64_t tick;
+      /* Time the state stands for, in nanoseconds */
+      std::int64_t time;
+    } t_state_slot;
+
+    t_state_slot _slots[Count];
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> _published;
+
+    /* Writer side */
+    alignas(CACHE_LINE_SIZE) std::uint32_t _next;
+    std::uint32_t _last;
+
+    /* Reader side */
+    alignas(CACHE_LINE_SIZE) std::uint32_t _latest;
+    std::uint32_t _previous;
+
+  public:
+    StateBuffer(T const &initial = T()) :
+      _published(1),
+      _next(0),
+      _last(1),
+      _latest(2),
+      _previous(Count == 4 ? 3 : 2)
+    {
+      for (std::uint32_t i = 0; i < Count; i++)
+      {
+        this->_slots[i].state = initial;
+        this->_slots[i].tick = 0;
+        this->_slots[i].time = 0;
+      }
+    }
+
+    StateBuffer(StateBuffer const &) = delete;
+    void operator=(StateBuffer const &) = delete;
+
+    /* Writer: last published state, still readable while the next one is built */
+    T const &getLast() const
+    {
+      return (this->_slots[this->_last].state);
+    }
+
+    /* Writer: state to build, published by publish() */
+    T &getNext()
+    {
+      return (this->_slots[this->_next].state);
+    }
+
+    std::uint64_t getLastTick() const
+    {
+      return (this->_slots[this->_last].tick);
+    }
+
+    /* Writer: publishes the next state, standing for the given time */
+    void publish(std::int64_t const time)
+    {
+      this->_slots[this->_next].tick = this->_slots[this->_last].tick + 1;
+      this->_slots[this->_next].time = time;
+      this->_last = this->_next;
+
+      /* The slot given back is either the one published before, or one left by the reader */
+      this->_next = this->_published.exchange(this->_next | STATE_BUFFER_FRESH, std::memory_order_acq_rel) & STATE_BUFFER_INDEX;
+    }
+
+    /* Reader: takes the state published last, false when there is none since the previous call */
+    bool update()
+    {
+      std::uint32_t taken;
+
+      if (!(this->_published.load(std::memory_order_relaxed) & STATE_BUFFER_FRESH))
+        return (false);
+      taken = this->_published.exchange(Count == 4 ? this->_previous : this->_latest, std::memory_order_acq_rel) & STATE_BUFFER_INDEX;
+      this->_previous = Count == 4 ? this->_latest : taken;
+      this->_latest = taken;
+      return (true);
+    }
+
+    /* Reader: the latest state taken, and the one taken before it */
+    T const &getLatest() const
+    {
+      return (this->_slots[this->_latest].state);
+    }
+
+    T const &getPrevious() const
+    {
+      return (this->_slots[this->_previous].state);
+    }
+
+    std::uint64_t getLatestTick() const
+    {
+      return (this->_slots[this->_latest].tick);
+    }
+
+    /*
+    ** Reader: place of a time between the previous and the latest states,
+    ** from 0 (previous) to 1 (latest). The reader may have missed states in
+    ** between: the times of the two it holds are used, not a tick duration.
+    */
+    float getAlpha(std::int64_t const time) const
+    {
+      std::int64_t from = this->_slots[this->_previous].time;
+      std::int64_t to = this->_slots[this->_latest].time;
+
+      if (to <= from || time >= to)
+        return (1.0f);
+      if (time <= from)
+        return (0.0f);
+      return ((float) (time - from) / (float) (to - from));
+    }
+  };
+};
\ No newline at end of file
@@ -0,0 +1,124 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Cores a thread may run on, one bit per core: no bit leaves it to the system */
+#define THREAD_ANY_CORE 0
+#define THREAD_CORE(Index) ((std::uint64_t) 1 << (Index))
+
+/* Longest name shown by the system, the rest is cut */
+#define THREAD_NAME_MAX_SIZE 15
+
+namespace ek
+{
+  /*
+  ** Long-lived threads of the program: main, game, audio, network.
+  ** Each thread is started with a name, the cores it may run on and a
+  ** priority; they are set by the thread itself before its function runs,
+  ** and a failure only leaves a warning. Raising a priority usually needs
+  ** privileges: priorities are hints.
+  ** Shutdown: stop() raises the stop flag, wakes the threads sleeping in
+  ** sleepFor() and calls the wake function of each thread, for the ones
+  ** sleeping on their own events. join() then joins the threads, the last
+  ** started first. A thread ending on an exception stops every thread.
+  ** Only the owner of the manager joins or destroys it: join() called from a
+  ** managed thread logs an error and returns.
+  */
+  class ThreadManager
+  {
+  public:
+
+    enum Priority
+    {
+      Low,
+      Normal,
+      High,
+      Critical
+    };
+
+  private:
+    typedef struct s_managed_thread {
+      std::string name;
+      std::uint64_t affinity;
+      Priority priority;
+      std::function<void()> wake;
+      std::thread thread;
+      /* Taken by a join(), so that another one skips it */
+      bool joined;
+    } t_managed_thread;
+
+    void  _run(std::shared_ptr<t_managed_thread>, std::function<void(ThreadManager &)>);
+
+    std::atomic<bool> _running;
+
+    std::mutex _threadsMutex;
+    /* Kept until the manager is destroyed, and by each thread while it runs */
+    std::vector<std::shared_ptr<t_managed_thread>> _threads;
+
+    std::mutex _sleepMutex;
+    std::condition_variable _sleep;
+
+  public:
+    ThreadManager();
+    ~ThreadManager();
+
+    ThreadManager(ThreadManager const &) = delete;
+    void operator=(ThreadManager const &) = delete;
+
+    /* Starts a thread running function until it returns, false once stopping */
+    bool spawn(std::string const &, std::function<void(ThreadManager &)>,
+               std::uint64_t = THREAD_ANY_CORE, Priority = Normal, std::function<void()> = nullptr);
+
+    /* False once stop() is called: the loop of each thread checks it */
+    bool isRunning() const;
+
+    /* Sleeps for a duration or until stop(), false when stopping */
+    bool sleepFor(std::chrono::nanoseconds const);
+
+    void stop();
+    void join();
+
+    /* Threads started and not joined yet */
+    std::uint32_t getThreadCount();
+
+    /* Settings of the calling thread, for the main thread or threads made elsewhere */
+    static bool setCurrentName(std::string const &);
+    static bool setCurrentAffinity(std::uint64_t const);
+    static bool setCurrentPriority(Priority const);
+    static std::string getCurrentName();
+
+    static std::uint32_t getCoreCount();
+  };
+};
\ No newline at end of file
@@ -0,0 +1,157 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Default size of the ring of each logging thread */
+#define DEFAULT_LOG_RING_SIZE 65536
+
+/* Longest record: longer ones are truncated */
+#define LOG_RECORD_MAX_SIZE 512
+
+/* Size of the writes of the writer thread */
+#define LOG_WRITE_BATCH_SIZE 65536
+
+/* Sleep of the writer thread when every ring is empty, in milliseconds */
+#define LOG_FLUSH_INTERVAL 2
+
+#define LOG_CACHE_LINE_SIZE 64
+
+namespace ek
+{
+  /*
+  ** Logger backend writing from a background thread.
+  ** Each logging thread owns a single producer ring, so committing a record
+  ** is a copy and a store. The writer thread gathers the rings into large
+  ** writes to a file descriptor. When a ring is full the record is either
+  ** dropped and counted, or the thread waits for the writer.
+  ** While an AsyncLogger lives, every LOG statement goes through it; threads
+  ** still logging must be stopped before it is destroyed.
+  ** The Binary encoding writes the format of the LogFormat.hpp statements
+  ** once, then their raw arguments; ek-log-decode turns it back into text.
+  */
+  class AsyncLogger
+  {
+  public:
+
+    enum OverflowPolicy
+    {
+      Drop,
+      Block
+    };
+
+    enum Encoding
+    {
+      Text,
+      Binary
+    };
+
+  private:
+    typedef struct s_log_ring {
+      alignas(LOG_CACHE_LINE_SIZE) std::atomic<std::uint64_t> head;
+      alignas(LOG_CACHE_LINE_SIZE) std::atomic<std::uint64_t> tail;
+      std::atomic<bool> closed;
+      char *data;
+    } t_log_ring;
+
+    class RecordBuffer;
+    class ThreadStream;
+
+    void  _start();
+
+    ThreadStream &_local();
+
+    t_log_ring *_register();
+    bool  _push(t_log_ring *, char const *, std::uint64_t const);
+    void  _wake();
+
+    void  _run();
+    bool  _drain();
+    void  _write();
+
+    static std::atomic<AsyncLogger *> _instance;
+    static std::atomic<std::uint64_t> _instanceId;
+    static std::atomic<std::uint64_t> _nextId;
+
+    std::uint64_t _id;
+    int _fd;
+    bool _ownsFd;
+    OverflowPolicy _policy;
+    Encoding _encoding;
+    std::uint64_t _ringSize;
+
+    std::mutex _ringsMutex;
+    std::vector<t_log_ring *> _rings;
+    /* Copy of the rings drained by the writer, without the lock: only the writer removes rings */
+    std::vector<t_log_ring *> _drainRings;
+
+    std::atomic<bool> _running;
+    std::atomic<bool> _wakeRequested;
+    std::mutex _wakeMutex;
+    std::condition_variable _wakeUp;
+
+    std::atomic<std::uint64_t> _passes;
+    std::mutex _flushMutex;
+    std::condition_variable _flushed;
+
+    std::atomic<std::uint64_t> _dropped;
+    std::uint64_t _reportedDrops;
+
+    char *_batch;
+    std::uint64_t _batchSize;
+
+    std::thread _writer;
+
+  public:
+    AsyncLogger(int = 1, OverflowPolicy = Drop, std::uint64_t = DEFAULT_LOG_RING_SIZE, Encoding = Text);
+    AsyncLogger(std::string const &, OverflowPolicy = Drop, std::uint64_t = DEFAULT_LOG_RING_SIZE, Encoding = Text);
+    ~AsyncLogger();
+
+    AsyncLogger(AsyncLogger const &) = delete;
+    void operator=(AsyncLogger const &) = delete;
+
+    /* Stream of the calling thread: a record is committed on each flush (std::endl) */
+    std::ostream &stream();
+
+    /* Commits an encoded record to the ring of the calling thread, false when it is dropped */
+    bool write(char const *, std::uint64_t const);
+
+    /* Waits until the records committed before the call are written */
+    void flush();
+
+    std::uint64_t getDroppedCount() const;
+    std::uint64_t getId() const;
+    bool isBinary() const;
+
+    static AsyncLogger *getInstance();
+  };
+};
\ No newline at end of file
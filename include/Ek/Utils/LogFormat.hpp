@@ -0,0 +1,197 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#include "Ek/Utils/AsyncLogger.hpp"
+#include "Ek/Utils/Logger.hpp"
+
+/* A binary log starts with this magic, once per AsyncLogger */
+#define LOG_BINARY_MAGIC "EKLOG01\n"
+#define LOG_BINARY_MAGIC_SIZE 8
+
+/* Records: a tag and the record size on two bytes, in host byte order */
+#define LOG_RECORD_HEADER_SIZE 3
+#define LOG_RECORD_SITE 'S'
+#define LOG_RECORD_FORMAT 'F'
+#define LOG_RECORD_TEXT 'T'
+
+/* Site records: id, level, line, then the file and the format, nul terminated */
+#define LOG_SITE_FILE_MAX_SIZE 128
+
+/* Format records: site id and timestamp, then the arguments */
+#define LOG_FORMAT_ARGS_OFFSET (LOG_RECORD_HEADER_SIZE + 4 + 8)
+
+/*
+** Argument types, followed by a varint for integers (zigzag encoded when
+** signed), 8 bytes for floats and pointers, 1 byte for chars and booleans,
+** or a size on two bytes and the string.
+*/
+#define LOG_ARG_INT 1
+#define LOG_ARG_UINT 2
+#define LOG_ARG_FLOAT 3
+#define LOG_ARG_POINTER 4
+#define LOG_ARG_STRING 5
+#define LOG_ARG_CHAR 6
+#define LOG_ARG_BOOL 7
+
+/* Static description of a statement, built on its first run */
+#define LOG_SITE(Level, Format) ([]() -> ek::t_log_site & { static ek::t_log_site site = {Level, __FILE__, __LINE__, Format, ek::LogFormat::nextSiteId(), {0}}; return (site); }())
+
+/* Statement with a constant format, {} standing for the arguments */
+#define LOG_FMT(Level, Format, ...) ((((EK_LOG_CATEGORY) & (EK_LOG_CATEGORIES)) && ek::Logger::isEnabled(Level, EK_LOG_CATEGORY)) ? ek::LogFormat::write(LOG_SITE(Level, Format), ##__VA_ARGS__) : (void) 0)
+
+#if EK_LOG_LEVEL >= LOG_LEVEL_ERROR
+  #define ERROR_FMT(Format, ...) LOG_FMT(LOG_LEVEL_ERROR, Format, ##__VA_ARGS__)
+#else
+  #define ERROR_FMT(Format, ...) ((void) 0)
+#endif
+
+#if EK_LOG_LEVEL >= LOG_LEVEL_WARN
+  #define WARN_FMT(Format, ...) LOG_FMT(LOG_LEVEL_WARN, Format, ##__VA_ARGS__)
+#else
+  #define WARN_FMT(Format, ...) ((void) 0)
+#endif
+
+#if EK_LOG_LEVEL >= LOG_LEVEL_DEBUG
+  #define DEBUG_FMT(Format, ...) LOG_FMT(LOG_LEVEL_DEBUG, Format, ##__VA_ARGS__)
+#else
+  #define DEBUG_FMT(Format, ...) ((void) 0)
+#endif
+
+#if EK_LOG_LEVEL >= LOG_LEVEL_TRACE
+  #define TRACE_FMT(Format, ...) LOG_FMT(LOG_LEVEL_TRACE, Format, ##__VA_ARGS__)
+#else
+  #define TRACE_FMT(Format, ...) ((void) 0)
+#endif
+
+namespace ek
+{
+  typedef struct s_log_site {
+    int level;
+    char const *file;
+    std::uint32_t line;
+    char const *format;
+    std::uint32_t id;
+    /* Id of the AsyncLogger which got the site record */
+    std::atomic<std::uint64_t> writtenBy;
+  } t_log_site;
+
+  /*
+  ** Binary record built on the stack: arguments are copied with their type,
+  ** and left out once the record is full.
+  */
+  class LogRecord
+  {
+  private:
+    char _data[LOG_RECORD_MAX_SIZE];
+    std::uint64_t _size;
+    bool _full;
+
+    void  _putArgument(std::uint8_t const, void const *, std::uint64_t const);
+    void  _putVarint(std::uint8_t const, std::uint64_t);
+
+  public:
+    LogRecord(char const);
+
+    LogRecord(LogRecord const &) = delete;
+    void operator=(LogRecord const &) = delete;
+
+    void put(void const *, std::uint64_t const);
+    void putString(char const *);
+
+    void add(bool const);
+    void add(char const);
+    void add(char const *);
+    void add(std::string const &);
+
+    template <typename T>
+    void add(T const &value)
+    {
+      if constexpr (std::is_enum<T>::value || (std::is_integral<T>::value && std::is_signed<T>::value))
+      {
+        std::int64_t argument = (std::int64_t) value;
+
+        this->_putVarint(LOG_ARG_INT, ((std::uint64_t) argument << 1) ^ (std::uint64_t) (argument >> 63));
+      }
+      else if constexpr (std::is_integral<T>::value)
+      {
+        this->_putVarint(LOG_ARG_UINT, (std::uint64_t) value);
+      }
+      else if constexpr (std::is_floating_point<T>::value)
+      {
+        double argument = (double) value;
+
+        this->_putArgument(LOG_ARG_FLOAT, &argument, sizeof(argument));
+      }
+      else if constexpr (std::is_array<T>::value || std::is_same<T, char *>::value)
+        this->add((char const *) value);
+      else
+      {
+        static_assert(std::is_pointer<T>::value, "LogRecord: unsupported argument type");
+        std::uint64_t argument = (std::uint64_t) (std::uintptr_t) value;
+
+        this->_putArgument(LOG_ARG_POINTER, &argument, sizeof(argument));
+      }
+    }
+
+    char const *getData();
+    std::uint64_t getSize() const;
+  };
+
+  /*
+  ** Statements with a constant format.
+  ** With a binary AsyncLogger, a statement writes its site once, then only
+  ** its site id and raw arguments: formatting is left to ek-log-decode.
+  ** Otherwise it is formatted right away, like the stream statements.
+  */
+  class LogFormat
+  {
+  public:
+    static std::uint32_t nextSiteId();
+
+    template <typename... Args>
+    static void write(t_log_site &site, Args const &... args)
+    {
+      LogRecord record(LOG_RECORD_FORMAT);
+
+      begin(site, record);
+      (record.add(args), ...);
+      commit(site, record);
+    }
+
+    static void begin(t_log_site const &, LogRecord &);
+    static void commit(t_log_site &, LogRecord &);
+
+    static char const *prefix(int const);
+
+    /* Writes a format with the arguments of a format record in place of its {} */
+    static bool format(std::ostream &, char const *, char const *, std::uint64_t const);
+  };
+};
\ No newline at end of file
@@ -23,12 +23,70 @@
 
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 
-#define ERROR(Stream) (Logger::error_stream() << "ERR " << Stream << std::endl)
-#define WARN(Stream) (Logger::warn_stream() << "WARN " << Stream << std::endl)
-#define DEBUG(Stream) (Logger::debug_stream() << "DEB " << Stream << std::endl)
+/* Log levels: statements above EK_LOG_LEVEL are not built at all */
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_DEBUG 3
+#define LOG_LEVEL_TRACE 4
+
+/* Log categories, as masks */
+#define LOG_CATEGORY_GENERAL 0x1
+#define LOG_CATEGORY_MEMORY 0x2
+#define LOG_CATEGORY_GFX 0x4
+#define LOG_CATEGORY_THREADS 0x8
+#define LOG_CATEGORY_ALL 0xFFFFFFFF
+
+/* Highest level built: debug messages are left out of release builds */
+#ifndef EK_LOG_LEVEL
+  #ifdef NDEBUG
+    #define EK_LOG_LEVEL LOG_LEVEL_WARN
+  #else
+    #define EK_LOG_LEVEL LOG_LEVEL_DEBUG
+  #endif
+#endif
+
+/* Categories built */
+#ifndef EK_LOG_CATEGORIES
+  #define EK_LOG_CATEGORIES LOG_CATEGORY_ALL
+#endif
+
+/* Category of the statements of a file, given by its module */
+#ifndef EK_LOG_CATEGORY
+  #define EK_LOG_CATEGORY LOG_CATEGORY_GENERAL
+#endif
+
+/* Built statement, filtered at runtime: the stream is only evaluated when the statement is enabled */
+#define LOG(Level, Stream) ((((EK_LOG_CATEGORY) & (EK_LOG_CATEGORIES)) && Logger::isEnabled(Level, EK_LOG_CATEGORY)) ? (void) (Logger::stream(Level) << Stream << std::endl) : (void) 0)
+
+#if EK_LOG_LEVEL >= LOG_LEVEL_ERROR
+  #define ERROR(Stream) LOG(LOG_LEVEL_ERROR, "ERR " << Stream)
+#else
+  #define ERROR(Stream) ((void) 0)
+#endif
+
+#if EK_LOG_LEVEL >= LOG_LEVEL_WARN
+  #define WARN(Stream) LOG(LOG_LEVEL_WARN, "WARN " << Stream)
+#else
+  #define WARN(Stream) ((void) 0)
+#endif
+
+#if EK_LOG_LEVEL >= LOG_LEVEL_DEBUG
+  #define DEBUG(Stream) LOG(LOG_LEVEL_DEBUG, "DEB " << Stream)
+#else
+  #define DEBUG(Stream) ((void) 0)
+#endif
+
+/* Messages of hot paths, once per allocation for instance */
+#if EK_LOG_LEVEL >= LOG_LEVEL_TRACE
+  #define TRACE(Stream) LOG(LOG_LEVEL_TRACE, "TRA " << Stream)
+#else
+  #define TRACE(Stream) ((void) 0)
+#endif
 
 namespace ek
 {
@@ -43,5 +101,13 @@ namespace ek
 
     static void debug(std::string const &);
     static std::ostream &debug_stream();
+
+    /* Standard streams, or the stream of the calling thread when an AsyncLogger is installed */
+    static std::ostream &stream(int const);
+
+    /* Runtime filter of the built statements: every level and category by default */
+    static void setLevel(int const);
+    static void setCategories(std::uint32_t const);
+    static bool isEnabled(int const, std::uint32_t const);
   };
 };
\ No newline at end of file
@@ -27,4 +27,7 @@
 #define MAX(a, b) ((a > b) ? a : b)
 
 /* Returns min value between a and b */
-#define MIN(a, b) ((a < b) ? a : b)
\ No newline at end of file
+#define MIN(a, b) ((a < b) ? a : b)
+
+/* Returns the biggest power of two dividing a */
+#define POW2_DIVISOR(a) ((a) & (~(a) + 1))
\ No newline at end of file
@@ -0,0 +1,334 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "Ek/Memory/AllocationTracer.hpp"
+#include "Ek/Utils/Config.hpp"
+#include "Ek/Utils/Maths.hpp"
+#include "Ek/Utils/Logger.hpp"
+
+#if defined(EK_SYSTEM_UNIX) || defined(EK_SYSTEM_MACOS)
+  #include <execinfo.h>
+  #define EK_ALLOCATION_TRACER_BACKTRACE
+#endif
+
+/* Table words which are not block addresses */
+#define TRACE_BLOCK_EMPTY 0x0
+#define TRACE_BLOCK_REMOVED 0x1
+#define TRACE_BLOCK_WRITING 0x2
+
+/* Frames of the tracer, skipped when the allocator code is not in its own section */
+#define TRACE_SKIPPED_FRAMES 2
+
+/* Room for the frames of the tracer and the allocators, stripped from the backtrace */
+#define TRACE_EXTRA_FRAMES 8
+
+/* Bounds of the allocator code section, set by the linker; null when it is not built */
+#if defined(EK_ALLOCATION_TRACING) && defined(__ELF__)
+extern "C" char __start_ek_allocator_code[] __attribute__((weak));
+extern "C" char __stop_ek_allocator_code[] __attribute__((weak));
+#endif
+
+namespace ek
+{
+  std::atomic<std::uint32_t> AllocationTracer::_sampleRate(ALLOCATION_TRACER_SAMPLE_RATE);
+  std::atomic<std::uint64_t> AllocationTracer::_dropped(0);
+  std::atomic<std::uint64_t> AllocationTracer::_liveSamples(0);
+  std::chrono::steady_clock::time_point AllocationTracer::_start = std::chrono::steady_clock::now();
+
+  std::mutex AllocationTracer::_sitesMutex;
+  std::atomic<std::uint32_t> AllocationTracer::_siteCount(0);
+  AllocationTracer::t_trace_site AllocationTracer::_sites[ALLOCATION_TRACER_MAX_SITES];
+  AllocationTracer::t_trace_block AllocationTracer::_blocks[ALLOCATION_TRACER_TABLE_SIZE];
+  std::atomic<std::uint32_t> AllocationTracer::_pages[ALLOCATION_TRACER_PAGE_BUCKETS];
+
+  namespace
+  {
+    /* Allocations left before the next sample of this thread */
+    thread_local std::uint64_t sampleCountdown = 0;
+    thread_local std::uint64_t sampleSeed = 0;
+
+    /* Random countdown in [1, 2 * rate]: one in rate on average, without following a pattern of the program */
+    std::uint64_t nextCountdown(std::uint32_t const rate)
+    {
+      if (rate == 1)
+        return (1);
+      if (sampleSeed == 0)
+        sampleSeed = ((std::uintptr_t) &sampleSeed) | 1;
+      sampleSeed ^= sampleSeed << 13;
+      sampleSeed ^= sampleSeed >> 7;
+      sampleSeed ^= sampleSeed << 17;
+      return (1 + (sampleSeed >> 32) % (2 * (std::uint64_t) rate));
+    }
+
+    std::uint64_t hashPointer(std::uintptr_t const ptr)
+    {
+      return ((ptr >> 4) * 0x9E3779B97F4A7C15ULL);
+    }
+
+    /* Number of frames of the tracer and the allocators at the top of a backtrace */
+    std::uint32_t allocatorFrames(void * const *frames, std::uint32_t const frameCount)
+    {
+      std::uint32_t count = 0;
+
+#if defined(EK_ALLOCATION_TRACING) && defined(__ELF__)
+      if (__start_ek_allocator_code != nullptr)
+      {
+        while (count < frameCount && (char *) frames[count] >= __start_ek_allocator_code && (char *) frames[count] < __stop_ek_allocator_code)
+          count++;
+        return (count);
+      }
+#endif
+      (void) frames;
+      count = TRACE_SKIPPED_FRAMES;
+      return (MIN(count, frameCount));
+    }
+
+    /* Reports the blocks never freed, once the program is over */
+    struct s_trace_exit_report {
+      ~s_trace_exit_report()
+      {
+#if defined(EK_ALLOCATION_TRACING)
+        AllocationTracer::report(std::cerr);
+#endif
+      }
+    } traceExitReport;
+  };
+
+  std::uint32_t AllocationTracer::_siteOf(void * const *frames, std::uint32_t const frameCount)
+  {
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    std::uint32_t siteCount;
+    t_trace_site *site;
+
+    for (std::uint32_t i = 0; i < frameCount; i++)
+      hash = (hash ^ (std::uintptr_t) frames[i]) * 0x100000001B3ULL;
+
+    /* Sites are never removed: the known ones are searched without the lock */
+    siteCount = _siteCount.load(std::memory_order_acquire);
+    for (std::uint32_t i = 0; i < siteCount; i++)
+      if (_sites[i].hash == hash && _sites[i].frameCount == frameCount && std::equal(frames, frames + frameCount, _sites[i].frames))
+        return (i);
+
+    std::lock_guard<std::mutex> lock(_sitesMutex);
+
+    for (std::uint32_t i = siteCount; i < _siteCount.load(std::memory_order_relaxed); i++)
+      if (_sites[i].hash == hash && _sites[i].frameCount == frameCount && std::equal(frames, frames + frameCount, _sites[i].frames))
+        return (i);
+    siteCount = _siteCount.load(std::memory_order_relaxed);
+    if (siteCount == ALLOCATION_TRACER_MAX_SITES)
+      return (ALLOCATION_TRACER_MAX_SITES);
+    site = &_sites[siteCount];
+    std::copy(frames, frames + frameCount, site->frames);
+    site->frameCount = frameCount;
+    site->hash = hash;
+    _siteCount.store(siteCount + 1, std::memory_order_release);
+    return (siteCount);
+  }
+
+  std::atomic<std::uint32_t> &AllocationTracer::_pageSamples(std::uintptr_t const ptr)
+  {
+    return (_pages[((ptr >> ALLOCATION_TRACER_PAGE_SHIFT) * 0x9E3779B97F4A7C15ULL >> 32) & (ALLOCATION_TRACER_PAGE_BUCKETS - 1)]);
+  }
+
+  AllocationTracer::t_trace_block *AllocationTracer::_find(void *ptr)
+  {
+    std::uint64_t index = hashPointer((std::uintptr_t) ptr);
+    std::uintptr_t current;
+
+    /* Removed entries are taken again by new samples: no block lies further than the probes */
+    for (std::uint64_t i = 0; i < ALLOCATION_TRACER_MAX_PROBES; i++)
+    {
+      index &= ALLOCATION_TRACER_TABLE_SIZE - 1;
+      current = _blocks[index].ptr.load(std::memory_order_acquire);
+      if (current == (std::uintptr_t) ptr)
+        return (&_blocks[index]);
+      if (current == TRACE_BLOCK_EMPTY)
+        return (nullptr);
+      index++;
+    }
+    return (nullptr);
+  }
+
+  TRACE_ALLOCATOR_CODE void AllocationTracer::_sample(void *ptr, std::uint64_t const size)
+  {
+    void *frames[ALLOCATION_TRACER_MAX_FRAMES + TRACE_EXTRA_FRAMES];
+    std::uint64_t index = hashPointer((std::uintptr_t) ptr);
+    std::uint32_t frameCount = 0;
+    std::uint32_t skipped;
+    std::uint32_t siteIndex;
+    std::uintptr_t current;
+    t_trace_site *site;
+
+#if defined(EK_ALLOCATION_TRACER_BACKTRACE)
+    frameCount = backtrace(frames, ALLOCATION_TRACER_MAX_FRAMES + TRACE_EXTRA_FRAMES);
+#endif
+    skipped = allocatorFrames(frames, frameCount);
+    frameCount = MIN(frameCount - skipped, ALLOCATION_TRACER_MAX_FRAMES);
+    siteIndex = _siteOf(frames + skipped, frameCount);
+    if (siteIndex == ALLOCATION_TRACER_MAX_SITES)
+    {
+      _dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    site = &_sites[siteIndex];
+    site->allocations.fetch_add(1, std::memory_order_relaxed);
+    site->allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    /* The entry is claimed, filled, then published with the block address */
+    for (std::uint64_t i = 0; i < ALLOCATION_TRACER_MAX_PROBES; i++)
+    {
+      index &= ALLOCATION_TRACER_TABLE_SIZE - 1;
+      current = _blocks[index].ptr.load(std::memory_order_relaxed);
+      if ((current == TRACE_BLOCK_EMPTY || current == TRACE_BLOCK_REMOVED) &&
+          _blocks[index].ptr.compare_exchange_strong(current, TRACE_BLOCK_WRITING, std::memory_order_acquire))
+      {
+        _blocks[index].site = siteIndex;
+        _blocks[index].size = size;
+        site->liveBytes.fetch_add(size, std::memory_order_relaxed);
+        site->liveBlocks.fetch_add(1, std::memory_order_relaxed);
+        _liveSamples.fetch_add(1, std::memory_order_relaxed);
+        _pageSamples((std::uintptr_t) ptr).fetch_add(1, std::memory_order_relaxed);
+        _blocks[index].ptr.store((std::uintptr_t) ptr, std::memory_order_release);
+        return;
+      }
+      index++;
+    }
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  TRACE_ALLOCATOR_CODE void AllocationTracer::onAllocate(void *ptr, std::uint64_t const size)
+  {
+    std::uint32_t rate = _sampleRate.load(std::memory_order_relaxed);
+
+    if (rate == 0)
+      return;
+    if (sampleCountdown == 0)
+      sampleCountdown = nextCountdown(rate);
+    if (--sampleCountdown == 0)
+      _sample(ptr, size);
+  }
+
+  void AllocationTracer::_remove(t_trace_block *block, std::uintptr_t ptr)
+  {
+    std::uint32_t siteIndex = block->site;
+    std::uint64_t size = block->size;
+    t_trace_site *site = &_sites[siteIndex];
+
+    /* A block freed on its own and within a range at once is only counted out once */
+    if (!block->ptr.compare_exchange_strong(ptr, TRACE_BLOCK_REMOVED, std::memory_order_acq_rel))
+      return;
+    site->liveBytes.fetch_sub(size, std::memory_order_relaxed);
+    site->liveBlocks.fetch_sub(1, std::memory_order_relaxed);
+    _liveSamples.fetch_sub(1, std::memory_order_relaxed);
+    _pageSamples(ptr).fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void AllocationTracer::onFree(void *ptr)
+  {
+    t_trace_block *block;
+
+    if (_liveSamples.load(std::memory_order_relaxed) == 0)
+      return;
+    block = _find(ptr);
+    if (block)
+      _remove(block, (std::uintptr_t) ptr);
+  }
+
+  void AllocationTracer::onFreeRange(void *begin, void *end)
+  {
+    std::uintptr_t first = (std::uintptr_t) begin >> ALLOCATION_TRACER_PAGE_SHIFT;
+    std::uintptr_t last = ((std::uintptr_t) end - 1) >> ALLOCATION_TRACER_PAGE_SHIFT;
+    std::uintptr_t current;
+    bool sampled = false;
+
+    if (_liveSamples.load(std::memory_order_relaxed) == 0 || begin >= end)
+      return;
+
+    /* Rewinds mostly free pages without any sample: the table is left alone */
+    if (last - first < ALLOCATION_TRACER_MAX_RANGE_PAGES)
+    {
+      for (std::uintptr_t page = first; page <= last && !sampled; page++)
+        sampled = _pageSamples(page << ALLOCATION_TRACER_PAGE_SHIFT).load(std::memory_order_relaxed) != 0;
+      if (!sampled)
+        return;
+    }
+
+    for (std::uint64_t i = 0; i < ALLOCATION_TRACER_TABLE_SIZE; i++)
+    {
+      current = _blocks[i].ptr.load(std::memory_order_acquire);
+      if (current >= (std::uintptr_t) begin && current < (std::uintptr_t) end)
+        _remove(&_blocks[i], current);
+    }
+  }
+
+  void AllocationTracer::setSampleRate(std::uint32_t const rate)
+  {
+    _sampleRate.store(rate, std::memory_order_relaxed);
+  }
+
+  std::uint32_t AllocationTracer::getSampleRate()
+  {
+    return (_sampleRate.load(std::memory_order_relaxed));
+  }
+
+  void AllocationTracer::report(std::ostream &stream)
+  {
+    std::uint32_t siteCount = _siteCount.load(std::memory_order_acquire);
+    std::uint64_t rate = MAX(_sampleRate.load(std::memory_order_relaxed), 1U);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+    std::vector<std::uint32_t> order;
+    char **symbols;
+    t_trace_site *site;
+
+    for (std::uint32_t i = 0; i < siteCount; i++)
+      order.push_back(i);
+    std::sort(order.begin(), order.end(), [](std::uint32_t a, std::uint32_t b) {
+      return (_sites[a].liveBytes.load(std::memory_order_relaxed) > _sites[b].liveBytes.load(std::memory_order_relaxed));
+    });
+
+    stream << "Allocation sites: 1 in " << rate << " allocations sampled over " << seconds << " s";
+    if (_dropped.load(std::memory_order_relaxed))
+      stream << ", " << _dropped.load(std::memory_order_relaxed) << " samples dropped";
+    stream << std::endl;
+    for (std::uint32_t i : order)
+    {
+      site = &_sites[i];
+      stream << "  ~" << site->liveBytes.load(std::memory_order_relaxed) * rate << " live bytes in ~"
+             << site->liveBlocks.load(std::memory_order_relaxed) * rate << " blocks, ~"
+             << (std::uint64_t) (site->allocations.load(std::memory_order_relaxed) * rate / seconds) << " allocations/s, ~"
+             << (std::uint64_t) (site->allocatedBytes.load(std::memory_order_relaxed) * rate / seconds) << " bytes/s" << std::endl;
+#if defined(EK_ALLOCATION_TRACER_BACKTRACE)
+      symbols = backtrace_symbols(site->frames, site->frameCount);
+      for (std::uint32_t frame = 0; symbols && frame < site->frameCount; frame++)
+        stream << "    #" << frame << " " << symbols[frame] << std::endl;
+      std::free(symbols);
+#else
+      (void) symbols;
+#endif
+    }
+  }
+};
\ No newline at end of file
@@ -0,0 +1,147 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <map>
+
+#include "Ek/Memory/AllocatorStats.hpp"
+#include "Ek/Utils/Logger.hpp"
+
+namespace ek
+{
+  std::mutex AllocatorStats::_registryMutex;
+  AllocatorStats *AllocatorStats::_registry = nullptr;
+
+  AllocatorStats::AllocatorStats(std::string const &name) :
+    _name(name),
+    _liveBytes(0),
+    _peakBytes(0),
+    _allocations(0),
+    _last(nullptr)
+  {
+    std::lock_guard<std::mutex> lock(_registryMutex);
+
+    for (std::uint64_t i = 0; i < ALLOCATOR_STATS_BUCKETS; i++)
+      this->_histogram[i] = 0;
+    this->_next = _registry;
+    if (this->_next)
+      this->_next->_last = this;
+    _registry = this;
+  }
+
+  AllocatorStats::~AllocatorStats()
+  {
+    std::lock_guard<std::mutex> lock(_registryMutex);
+
+    if (this->_liveBytes != 0)
+      WARN("AllocatorStats: Memory leaks detected in " << this->_name << ": " << this->_liveBytes << " bytes");
+    if (this->_last)
+      this->_last->_next = this->_next;
+    else
+      _registry = this->_next;
+    if (this->_next)
+      this->_next->_last = this->_last;
+  }
+
+  void AllocatorStats::onAllocate(std::uint64_t const size)
+  {
+    std::uint64_t live = this->_liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    std::uint64_t peak = this->_peakBytes.load(std::memory_order_relaxed);
+    std::uint64_t bucket = 0;
+
+    while (peak < live && !this->_peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+      ;
+    while (bucket < ALLOCATOR_STATS_BUCKETS - 1 && (size >> bucket) != 0)
+      bucket++;
+    this->_histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    this->_allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void AllocatorStats::onFree(std::uint64_t const size)
+  {
+    this->_liveBytes.fetch_sub(size, std::memory_order_relaxed);
+  }
+
+  std::string const &AllocatorStats::getName() const
+  {
+    return (this->_name);
+  }
+
+  std::uint64_t AllocatorStats::getLiveBytes() const
+  {
+    return (this->_liveBytes.load(std::memory_order_relaxed));
+  }
+
+  std::uint64_t AllocatorStats::getPeakBytes() const
+  {
+    return (this->_peakBytes.load(std::memory_order_relaxed));
+  }
+
+  std::uint64_t AllocatorStats::getAllocationCount() const
+  {
+    return (this->_allocations.load(std::memory_order_relaxed));
+  }
+
+  std::uint64_t AllocatorStats::getHistogram(std::uint64_t const bucket) const
+  {
+    return (this->_histogram[bucket].load(std::memory_order_relaxed));
+  }
+
+  void AllocatorStats::report(std::ostream &stream)
+  {
+    typedef struct s_merged_stats {
+      std::uint64_t liveBytes = 0;
+      std::uint64_t peakBytes = 0;
+      std::uint64_t allocations = 0;
+      std::uint64_t instances = 0;
+      std::uint64_t histogram[ALLOCATOR_STATS_BUCKETS] = {};
+    } t_merged_stats;
+
+    std::lock_guard<std::mutex> lock(_registryMutex);
+    std::map<std::string, t_merged_stats> merged;
+
+    for (AllocatorStats *stats = _registry; stats; stats = stats->_next)
+    {
+      t_merged_stats &values = merged[stats->_name];
+
+      values.liveBytes += stats->getLiveBytes();
+      values.peakBytes += stats->getPeakBytes();
+      values.allocations += stats->getAllocationCount();
+      values.instances++;
+      for (std::uint64_t i = 0; i < ALLOCATOR_STATS_BUCKETS; i++)
+        values.histogram[i] += stats->getHistogram(i);
+    }
+    for (auto const &entry : merged)
+    {
+      /* Instances peak at different times: their merged peak is only an upper bound, labelled as such */
+      stream << entry.first << ": live " << entry.second.liveBytes << " bytes, ";
+      if (entry.second.instances > 1)
+        stream << "sum of the peaks of " << entry.second.instances << " instances " << entry.second.peakBytes << " bytes, ";
+      else
+        stream << "peak " << entry.second.peakBytes << " bytes, ";
+      stream << entry.second.allocations << " allocations" << std::endl;
+      for (std::uint64_t i = 0; i < ALLOCATOR_STATS_BUCKETS; i++)
+        if (entry.second.histogram[i])
+          stream << "  < " << (1ULL << i) << " bytes: " << entry.second.histogram[i] << std::endl;
+    }
+  }
+};
\ No newline at end of file
@@ -0,0 +1,206 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <cstdlib>
+
+#include "Ek/Memory/ConcurrentFrameAllocator.hpp"
+#include "Ek/Utils/Maths.hpp"
+#include "Ek/Utils/Logger.hpp"
+
+/* Head word layout */
+#define HEAD_INDEX(Head) ((std::uint32_t) ((Head) & 0xFFFFFFFF))
+#define HEAD_TAG(Head) ((Head) >> 32)
+#define HEAD_MAKE(Tag, Index) ((((std::uint64_t) (Tag)) << 32) | (Index))
+
+namespace ek
+{
+  ConcurrentFrameAllocator::ConcurrentFrameAllocator(std::uint64_t pageSize, std::uint64_t slotSize, PageProvider *provider, std::uint64_t maxPages) :
+    _slotSize(MAX(ALIGN(slotSize, DEFAULT_ALIGN_SIZE), ALIGN(sizeof(t_concurrent_slot), DEFAULT_ALIGN_SIZE))),
+    _maxPages(maxPages),
+    _provider(provider),
+    _pageCount(0),
+    _head(0)
+  {
+    DEBUG("ConcurrentFrameAllocator: Constructor");
+
+    /* Pages are aligned on their size, a power of two: a slot finds its page header by masking its address */
+    this->_pageSize = MAX_ALIGN_SIZE;
+    while (this->_pageSize < pageSize)
+      this->_pageSize <<= 1;
+    if (this->_provider && this->_provider->getPageSize() != this->_pageSize)
+    {
+      ERROR("ConcurrentFrameAllocator: The page provider must use pages of " << this->_pageSize << " bytes");
+      throw std::bad_alloc();
+    }
+    this->_slotAlign = MIN(POW2_DIVISOR(this->_slotSize), MAX_ALIGN_SIZE);
+    this->_headerPageSize = ALIGN(sizeof(t_concurrent_page), this->_slotAlign);
+    this->_slotsPerPage = (this->_pageSize - this->_headerPageSize) / this->_slotSize;
+    if (this->_slotsPerPage == 0 || this->_slotsPerPage * this->_maxPages >= 0xFFFFFFFF)
+    {
+      ERROR("ConcurrentFrameAllocator: " << this->_maxPages << " pages of " << this->_slotsPerPage << " slots cannot be indexed on 32 bits");
+      throw std::bad_alloc();
+    }
+    this->_pages = (std::atomic<char *> *) std::calloc(this->_maxPages, sizeof(std::atomic<char *>));
+    if (this->_pages == nullptr)
+      throw std::bad_alloc();
+  }
+
+  ConcurrentFrameAllocator::~ConcurrentFrameAllocator()
+  {
+    std::uint64_t pageCount = this->_pageCount.load(std::memory_order_acquire);
+
+    DEBUG("ConcurrentFrameAllocator: Destructor");
+    for (std::uint64_t i = 0; i < pageCount; i++)
+      this->_systemFree(this->_pages[i].load(std::memory_order_relaxed), this->_pageSize);
+    std::free(this->_pages);
+  }
+
+  void *ConcurrentFrameAllocator::_systemAlloc(std::uint64_t const size)
+  {
+    void *ptr;
+
+    if (this->_provider)
+      return (this->_provider->allocate(size));
+    DEBUG("ConcurrentFrameAllocator: aligned_alloc(" << size << ")");
+    ptr = std::aligned_alloc(this->_pageSize, size);
+    if (ptr == nullptr)
+      throw std::bad_alloc();
+    return (ptr);
+  }
+
+  void ConcurrentFrameAllocator::_systemFree(void *ptr, std::uint64_t const size)
+  {
+    if (this->_provider)
+      this->_provider->free(ptr, size);
+    else
+    {
+      DEBUG("ConcurrentFrameAllocator: free(" << ptr << ")");
+      std::free(ptr);
+    }
+  }
+
+  void ConcurrentFrameAllocator::_pageAlloc(std::uint64_t const knownPages)
+  {
+    std::lock_guard<std::mutex> lock(this->_pagesMutex);
+    std::uint64_t index = this->_pageCount.load(std::memory_order_relaxed);
+    std::uint32_t first = index * this->_slotsPerPage;
+    t_concurrent_page *page;
+
+    /* Another thread added a page while this one was waiting for the lock */
+    if (index != knownPages)
+      return;
+    if (index == this->_maxPages)
+    {
+      ERROR("ConcurrentFrameAllocator: All the " << this->_maxPages << " pages are in use.");
+      throw std::bad_alloc();
+    }
+    page = (t_concurrent_page *) this->_systemAlloc(this->_pageSize);
+    page->index = index;
+    this->_pages[index].store((char *) page, std::memory_order_release);
+    this->_pageCount.store(index + 1, std::memory_order_release);
+
+    /* The slots of the page are chained, then pushed all at once */
+    for (std::uint32_t i = 0; i + 1 < this->_slotsPerPage; i++)
+      new (this->_slot(first + i)) t_concurrent_slot{ { first + i + 2 } };
+    new (this->_slot(first + this->_slotsPerPage - 1)) t_concurrent_slot{ { 0 } };
+    this->_push(first, first + this->_slotsPerPage - 1);
+  }
+
+  ConcurrentFrameAllocator::t_concurrent_slot *ConcurrentFrameAllocator::_slot(std::uint32_t const index) const
+  {
+    char *page = this->_pages[index / this->_slotsPerPage].load(std::memory_order_acquire);
+
+    return ((t_concurrent_slot *) (page + this->_headerPageSize + (index % this->_slotsPerPage) * this->_slotSize));
+  }
+
+  /* Pushes the chain of slots from first to last */
+  void ConcurrentFrameAllocator::_push(std::uint32_t const first, std::uint32_t const last)
+  {
+    t_concurrent_slot *lastSlot = this->_slot(last);
+    std::uint64_t head = this->_head.load(std::memory_order_relaxed);
+
+    do
+      lastSlot->next.store(HEAD_INDEX(head), std::memory_order_relaxed);
+    while (!this->_head.compare_exchange_weak(head, HEAD_MAKE(HEAD_TAG(head) + 1, first + 1), std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  void *ConcurrentFrameAllocator::allocate(std::uint64_t const size)
+  {
+    std::uint64_t head;
+    std::uint64_t pageCount;
+    std::uint32_t next;
+    t_concurrent_slot *slot;
+
+    if (size > this->_slotSize)
+    {
+      ERROR("ConcurrentFrameAllocator: A frame of " << size << " bytes has been asked; max frame size available: " << this->_slotSize << " bytes.");
+      throw std::bad_alloc();
+    }
+    head = this->_head.load(std::memory_order_acquire);
+    while (true)
+    {
+      if (HEAD_INDEX(head) == 0)
+      {
+        /* Read before the head is checked again: an empty stack with the same page count means a page is needed */
+        pageCount = this->_pageCount.load(std::memory_order_acquire);
+        head = this->_head.load(std::memory_order_acquire);
+        if (HEAD_INDEX(head) == 0)
+        {
+          this->_pageAlloc(pageCount);
+          head = this->_head.load(std::memory_order_acquire);
+        }
+        continue;
+      }
+
+      /* The slot may be popped and reused meanwhile: its next is then stale, and the tag makes the exchange fail */
+      slot = this->_slot(HEAD_INDEX(head) - 1);
+      next = slot->next.load(std::memory_order_relaxed);
+      if (this->_head.compare_exchange_weak(head, HEAD_MAKE(HEAD_TAG(head) + 1, next), std::memory_order_acquire, std::memory_order_acquire))
+        return ((void *) slot);
+    }
+  }
+
+  void *ConcurrentFrameAllocator::allocate(std::uint64_t const size, std::uint64_t const alignment)
+  {
+    if (alignment > this->_slotAlign)
+    {
+      ERROR("ConcurrentFrameAllocator: An alignment of " << alignment << " bytes has been asked; slots are aligned on " << this->_slotAlign << " bytes.");
+      throw std::bad_alloc();
+    }
+    return (this->allocate(size));
+  }
+
+  void ConcurrentFrameAllocator::free(void *ptr)
+  {
+    t_concurrent_page *page = (t_concurrent_page *) (((std::uintptr_t) ptr) & ~(this->_pageSize - 1));
+    std::uint32_t index = page->index * this->_slotsPerPage + (((char *) ptr) - ((char *) page) - this->_headerPageSize) / this->_slotSize;
+
+    new (ptr) t_concurrent_slot;
+    this->_push(index, index);
+  }
+
+  std::uint64_t ConcurrentFrameAllocator::getPageCount() const
+  {
+    return (this->_pageCount.load(std::memory_order_relaxed));
+  }
+};
\ No newline at end of file
@@ -0,0 +1,159 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <cstdlib>
+
+#include "Ek/Memory/DoubleFrameArena.hpp"
+#include "Ek/Utils/Maths.hpp"
+#include "Ek/Utils/Logger.hpp"
+
+namespace ek
+{
+  DoubleFrameArena::DoubleFrameArena(std::uint64_t pageSize, PageProvider *provider) :
+    _pageSize(ALIGN(pageSize, DEFAULT_ALIGN_SIZE)),
+    _pageHeaderSize(ALIGN(sizeof(t_arena_page), DEFAULT_ALIGN_SIZE)),
+    _provider(provider),
+    _current(&_arenas[0])
+  {
+    DEBUG("DoubleFrameArena: Constructor");
+    for (t_arena &arena : this->_arenas)
+    {
+      arena.first = nullptr;
+      arena.current = nullptr;
+      arena.top = nullptr;
+      arena.end = nullptr;
+    }
+  }
+
+  DoubleFrameArena::~DoubleFrameArena()
+  {
+    DEBUG("DoubleFrameArena: Destructor");
+    this->_release(&this->_arenas[0]);
+    this->_release(&this->_arenas[1]);
+  }
+
+  void *DoubleFrameArena::_systemAlloc(std::uint64_t const size)
+  {
+    void *ptr;
+
+    if (this->_provider)
+      return (this->_provider->allocate(size));
+    DEBUG("DoubleFrameArena: malloc(" << size << ")");
+    ptr = std::malloc(size);
+    if (ptr == nullptr)
+      throw std::bad_alloc();
+    return (ptr);
+  }
+
+  void DoubleFrameArena::_systemFree(void *ptr, std::uint64_t const size)
+  {
+    if (this->_provider)
+      this->_provider->free(ptr, size);
+    else
+    {
+      DEBUG("DoubleFrameArena: free(" << ptr << ")");
+      std::free(ptr);
+    }
+  }
+
+  void *DoubleFrameArena::_pageAlloc(std::uint64_t const size, std::uint64_t const alignment)
+  {
+    t_arena *arena = this->_current;
+    t_arena_page *page = arena->current ? arena->current->next : arena->first;
+    std::uint64_t pageSize = ALIGN(size + this->_pageHeaderSize + (alignment - DEFAULT_ALIGN_SIZE), this->_pageSize);
+    t_arena_page *newPage;
+    void *ptr;
+
+    /* Pages of the previous frames are kept; a new one is inserted only if the next is too small */
+    if (page == nullptr || page->size < pageSize)
+    {
+      TRACE("DoubleFrameArena: Page size exceeded");
+      newPage = (t_arena_page *) this->_systemAlloc(pageSize);
+      newPage->size = pageSize;
+      newPage->next = page;
+      if (arena->current)
+        arena->current->next = newPage;
+      else
+        arena->first = newPage;
+      page = newPage;
+    }
+    arena->current = page;
+    ptr = (void *) ALIGN(((std::uintptr_t) page) + this->_pageHeaderSize, alignment);
+    arena->top = ((char *) ptr) + size;
+    arena->end = ((char *) page) + page->size;
+    return (ptr);
+  }
+
+  void DoubleFrameArena::_reset(t_arena *arena)
+  {
+    arena->current = nullptr;
+    arena->top = nullptr;
+    arena->end = nullptr;
+  }
+
+  void DoubleFrameArena::_release(t_arena *arena)
+  {
+    t_arena_page *page;
+
+    while (arena->first)
+    {
+      page = arena->first->next;
+      this->_systemFree(arena->first, arena->first->size);
+      arena->first = page;
+    }
+    this->_reset(arena);
+  }
+
+  void *DoubleFrameArena::allocate(std::uint64_t const size)
+  {
+    return (this->allocate(size, DEFAULT_ALIGN_SIZE));
+  }
+
+  void *DoubleFrameArena::allocate(std::uint64_t const size, std::uint64_t const alignment)
+  {
+    t_arena *arena = this->_current;
+    std::uint64_t dataAlign = MAX(alignment, DEFAULT_ALIGN_SIZE);
+    char *ptr = (char *) ALIGN((std::uintptr_t) arena->top, dataAlign);
+
+    if (arena->top == nullptr || ptr + size > arena->end)
+      return (this->_pageAlloc(size, dataAlign));
+    arena->top = ptr + size;
+    return (ptr);
+  }
+
+  void DoubleFrameArena::free(void *)
+  {
+  }
+
+  void DoubleFrameArena::swap()
+  {
+    this->_current = (this->_current == &this->_arenas[0]) ? &this->_arenas[1] : &this->_arenas[0];
+    this->_reset(this->_current);
+  }
+
+  void DoubleFrameArena::reset()
+  {
+    this->_reset(&this->_arenas[0]);
+    this->_reset(&this->_arenas[1]);
+  }
+};
\ No newline at end of file
@@ -21,24 +21,41 @@
 // SOFTWARE.
 // 
 
+#include <cstdlib>
+
 #include "Ek/Memory/FrameAllocator.hpp"
+#include "Ek/Memory/AllocationTracer.hpp"
 #include "Ek/Utils/Maths.hpp"
 #include "Ek/Utils/Logger.hpp"
 
 namespace ek
 {
-  FrameAllocator::FrameAllocator(std::uint64_t pageSize, std::uint64_t slotSize) :
-    _headerPageSize(ALIGN(sizeof(t_frame_page), DEFAULT_ALIGN_SIZE)),
+  FrameAllocator::FrameAllocator(std::uint64_t pageSize, std::uint64_t slotSize, PageProvider *provider) :
     _headerSlotSize(ALIGN(sizeof(t_frame_slot), DEFAULT_ALIGN_SIZE)),
     _slotSize(MAX(ALIGN(slotSize, DEFAULT_ALIGN_SIZE), _headerSlotSize)),
-    _pageSize(ALIGN(pageSize, DEFAULT_ALIGN_SIZE))
+    _provider(provider),
+    _pageCount(0),
+    _emptyPageCount(0),
+    _trimThreshold(FRAME_TRIM_DISABLED),
+    _currentPage(nullptr),
+    _currentSlot(nullptr)
   {
     DEBUG("FrameAllocator: Constructor");
-    this->_currentPage = (t_frame_page *) this->_systemAlloc(this->_pageSize);
-    this->_currentPage->next = nullptr;
-    this->_currentSlot = (t_frame_slot *) (((char *) this->_currentPage) + this->_headerPageSize);
-    this->_currentSlot->size = (this->_pageSize - this->_headerPageSize) / this->_slotSize;
-    this->_currentSlot->next = nullptr;
+
+    /* Slots are aligned on the biggest power of two dividing their size: page header is aligned on it too */
+    this->_slotAlign = MIN(POW2_DIVISOR(this->_slotSize), MAX_ALIGN_SIZE);
+    this->_headerPageSize = ALIGN(sizeof(t_frame_page), this->_slotAlign);
+
+    /* Pages are aligned on their size, a power of two: a slot finds its page header by masking its address */
+    this->_pageSize = MAX_ALIGN_SIZE;
+    while (this->_pageSize < pageSize || this->_pageSize < this->_headerPageSize + this->_slotSize)
+      this->_pageSize <<= 1;
+    if (this->_provider && this->_provider->getPageSize() != this->_pageSize)
+    {
+      ERROR("FrameAllocator: The page provider must use pages of " << this->_pageSize << " bytes");
+      throw std::bad_alloc();
+    }
+    this->_pageAlloc();
   }
 
   FrameAllocator::~FrameAllocator()
@@ -49,21 +66,38 @@ namespace ek
     while (this->_currentPage)
     {
       page = this->_currentPage->next;
-      this->_systemFree(this->_currentPage);
+      this->_systemFree(this->_currentPage, this->_pageSize);
       this->_currentPage = page;
     }
   }
 
   void *FrameAllocator::_systemAlloc(std::uint64_t const size)
   {
-    DEBUG("FrameAllocator: malloc(" << size << ")");
-    return (std::malloc(size));
+    void *ptr;
+
+    if (this->_provider)
+      ptr = this->_provider->allocate(size);
+    else
+    {
+      DEBUG("FrameAllocator: aligned_alloc(" << size << ")");
+      ptr = std::aligned_alloc(this->_pageSize, size);
+      if (ptr == nullptr)
+        throw std::bad_alloc();
+    }
+    this->_pageCount++;
+    return (ptr);
   }
 
-  void FrameAllocator::_systemFree(void *ptr)
+  void FrameAllocator::_systemFree(void *ptr, std::uint64_t const size)
   {
-    DEBUG("FrameAllocator: free(0x" << ptr << ")");
-    std::free(ptr);
+    this->_pageCount--;
+    if (this->_provider)
+      this->_provider->free(ptr, size);
+    else
+    {
+      DEBUG("FrameAllocator: free(0x" << ptr << ")");
+      std::free(ptr);
+    }
   }
 
   void FrameAllocator::_pageAlloc()
@@ -72,18 +106,62 @@ namespace ek
 
     page = (t_frame_page *) this->_systemAlloc(this->_pageSize);
     page->next = this->_currentPage;
+    page->liveSlots = 0;
+    page->released = false;
     this->_currentPage = page;
+    this->_emptyPageCount++;
     this->_currentSlot = (t_frame_slot *) (((char *) this->_currentPage) + this->_headerPageSize);
     this->_currentSlot->size = (this->_pageSize - this->_headerPageSize) / this->_slotSize;
     this->_currentSlot->next = nullptr;
   }
 
+  FrameAllocator::t_frame_page *FrameAllocator::_page(void *ptr) const
+  {
+    return ((t_frame_page *) (((std::uintptr_t) ptr) & ~(this->_pageSize - 1)));
+  }
+
+  /* Releases the empty pages past the first retained ones */
+  void FrameAllocator::_pageRelease(std::uint64_t const retain)
+  {
+    std::uint64_t kept = 0;
+    t_frame_page **page;
+    t_frame_slot **slot;
+    t_frame_page *released;
+
+    DEBUG("FrameAllocator: Trim to " << retain << " empty pages");
+    for (released = this->_currentPage; released; released = released->next)
+      if (released->liveSlots == 0)
+        released->released = (kept++ >= retain);
+
+    /* A run never spans two pages: runs of released pages are unlinked whole */
+    slot = &this->_currentSlot;
+    while (*slot)
+      if (this->_page(*slot)->released)
+        *slot = (*slot)->next;
+      else
+        slot = &(*slot)->next;
+
+    page = &this->_currentPage;
+    while (*page)
+      if ((*page)->released)
+      {
+        released = *page;
+        *page = released->next;
+        this->_systemFree(released, this->_pageSize);
+        this->_emptyPageCount--;
+      }
+      else
+        page = &(*page)->next;
+  }
+
   void *FrameAllocator::_slotAlloc()
   {
     t_frame_slot *current;
     t_frame_slot *next;
 
     current = this->_currentSlot;
+    if (this->_page(current)->liveSlots++ == 0)
+      this->_emptyPageCount--;
     if (current->size > 1)
     {
       next = (t_frame_slot *) (((char *) current) + this->_slotSize);
@@ -96,11 +174,44 @@ namespace ek
     return ((void *) current);
   }
 
-  void *FrameAllocator::allocate(std::uint64_t const size) throw()
+  void FrameAllocator::_slotAllocN(std::uint64_t const count, void **out)
+  {
+    std::uint64_t done = 0;
+    std::uint64_t taken;
+    t_frame_slot *current;
+    t_frame_slot *next;
+
+    while (done < count)
+    {
+      if (!this->_currentSlot)
+        this->_pageAlloc();
+
+      /* Whole run or its beginning, split once */
+      current = this->_currentSlot;
+      taken = MIN(current->size, count - done);
+      if (this->_page(current)->liveSlots == 0)
+        this->_emptyPageCount--;
+      this->_page(current)->liveSlots += taken;
+      if (taken < current->size)
+      {
+        next = (t_frame_slot *) (((char *) current) + taken * this->_slotSize);
+        next->size = current->size - taken;
+        next->next = current->next;
+        this->_currentSlot = next;
+      }
+      else
+        this->_currentSlot = current->next;
+      for (std::uint64_t i = 0; i < taken; i++)
+        out[done + i] = ((char *) current) + i * this->_slotSize;
+      done += taken;
+    }
+  }
+
+  TRACE_ALLOCATOR_CODE void *FrameAllocator::allocate(std::uint64_t const size)
   {
     void *ptr = nullptr;
 
-    DEBUG("FrameAllocator: Allocate");
+    TRACE("FrameAllocator: Allocate");
     if (size > this->_slotSize)
     {
       ERROR("FrameAllocator: A frame of " << size << " bytes has been asked; max frame size available: " << this->_slotSize << " bytes.");
@@ -109,17 +220,103 @@ namespace ek
     if (!this->_currentSlot)
       this->_pageAlloc();
     ptr = this->_slotAlloc();
+    TRACE_ALLOCATE(ptr, size);
     return (ptr);
   }
 
+  TRACE_ALLOCATOR_CODE void *FrameAllocator::allocate(std::uint64_t const size, std::uint64_t const alignment)
+  {
+    if (alignment > this->_slotAlign)
+    {
+      ERROR("FrameAllocator: An alignment of " << alignment << " bytes has been asked; slots are aligned on " << this->_slotAlign << " bytes.");
+      throw std::bad_alloc();
+    }
+    return (this->allocate(size));
+  }
+
   void FrameAllocator::free(void *ptr)
   {
     t_frame_slot *slot;
 
-    DEBUG("FrameAllocator: Free");
+    TRACE("FrameAllocator: Free");
+    TRACE_FREE(ptr);
     slot = (t_frame_slot *) ptr;
     slot->size = 1;
     slot->next = this->_currentSlot;
     this->_currentSlot = slot;
+    if (--this->_page(slot)->liveSlots == 0 && ++this->_emptyPageCount > this->_trimThreshold)
+      this->_pageRelease(this->_trimThreshold / 2);
+  }
+
+  TRACE_ALLOCATOR_CODE void FrameAllocator::allocateN(std::uint64_t const size, std::uint64_t const count, void **out)
+  {
+    TRACE("FrameAllocator: Allocate " << count);
+    if (size > this->_slotSize)
+    {
+      ERROR("FrameAllocator: Frames of " << size << " bytes have been asked; max frame size available: " << this->_slotSize << " bytes.");
+      throw std::bad_alloc();
+    }
+    this->_slotAllocN(count, out);
+#if defined(EK_ALLOCATION_TRACING)
+    for (std::uint64_t i = 0; i < count; i++)
+      TRACE_ALLOCATE(out[i], size);
+#endif
+  }
+
+  TRACE_ALLOCATOR_CODE void FrameAllocator::allocateN(std::uint64_t const size, std::uint64_t const alignment, std::uint64_t const count, void **out)
+  {
+    if (alignment > this->_slotAlign)
+    {
+      ERROR("FrameAllocator: An alignment of " << alignment << " bytes has been asked; slots are aligned on " << this->_slotAlign << " bytes.");
+      throw std::bad_alloc();
+    }
+    this->allocateN(size, count, out);
+  }
+
+  void FrameAllocator::freeN(void * const *ptrs, std::uint64_t const count)
+  {
+    t_frame_slot *slot;
+    std::uint64_t i = 0;
+    std::uint64_t j;
+
+    TRACE("FrameAllocator: Free " << count);
+#if defined(EK_ALLOCATION_TRACING)
+    for (j = 0; j < count; j++)
+      TRACE_FREE(ptrs[j]);
+#endif
+    while (i < count)
+    {
+      /* Consecutive slots go back as a single run */
+      for (j = i + 1; j < count && ptrs[j] == ((char *) ptrs[j - 1]) + this->_slotSize; j++);
+      slot = (t_frame_slot *) ptrs[i];
+      slot->size = j - i;
+      slot->next = this->_currentSlot;
+      this->_currentSlot = slot;
+      if ((this->_page(slot)->liveSlots -= j - i) == 0)
+        this->_emptyPageCount++;
+      i = j;
+    }
+    if (this->_emptyPageCount > this->_trimThreshold)
+      this->_pageRelease(this->_trimThreshold / 2);
+  }
+  std::uint64_t FrameAllocator::getPageCount() const
+  {
+    return (this->_pageCount);
+  }
+
+  std::uint64_t FrameAllocator::getEmptyPageCount() const
+  {
+    return (this->_emptyPageCount);
+  }
+
+  void FrameAllocator::trim(std::uint64_t const retain)
+  {
+    if (this->_emptyPageCount > retain)
+      this->_pageRelease(retain);
+  }
+
+  void FrameAllocator::setTrimThreshold(std::uint64_t const threshold)
+  {
+    this->_trimThreshold = threshold;
   }
 };
\ No newline at end of file
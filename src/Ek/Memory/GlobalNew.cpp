@@ -0,0 +1,202 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "Ek/Memory/ThreadAllocator.hpp"
+#include "Ek/Memory/PoolAllocator.hpp"
+#include "Ek/Utils/Maths.hpp"
+
+/*
+** Replacement of the global operator new/delete, built when EK_OVERRIDE_NEW is set.
+** Small blocks come from the thread's pool, bigger ones from the system. A system
+** block keeps 0 in the word before it, where a pool block keeps its owner thread.
+** A thread destroying its thread_local objects may have released its pool
+** already: it allocates from the system, and its frees go to the owners' lists.
+*/
+
+/* Biggest block served by the pools, once their header has been added */
+#define GLOBAL_NEW_MAX_POOL_SIZE (DEFAULT_POOL_MAX_SIZE - CACHE_LINE_SIZE)
+
+/* Alignment of a default operator new */
+#define GLOBAL_NEW_ALIGN_SIZE __STDCPP_DEFAULT_NEW_ALIGNMENT__
+
+namespace
+{
+  typedef ek::ThreadAllocator<ek::PoolAllocator> t_global_allocator;
+
+  void *systemAlloc(std::size_t const size, std::size_t const alignment)
+  {
+    std::uintptr_t *header;
+    char *block;
+
+    /* The rounded size would wrap */
+    if (size > SIZE_MAX - 2 * alignment)
+      return (nullptr);
+    block = (char *) std::aligned_alloc(alignment, ALIGN(size + alignment, alignment));
+    if (block == nullptr)
+      return (nullptr);
+    header = (std::uintptr_t *) (block + alignment);
+    header[-1] = 0;
+    header[-2] = (std::uintptr_t) block;
+    return (header);
+  }
+
+  void *globalAlloc(std::size_t const size, std::size_t const alignment)
+  {
+    void *ptr;
+
+    if (size <= GLOBAL_NEW_MAX_POOL_SIZE && alignment <= CACHE_LINE_SIZE && !t_global_allocator::isExiting())
+      return (t_global_allocator::local().allocate(size, alignment));
+    ptr = systemAlloc(size, alignment);
+    if (ptr == nullptr)
+      throw std::bad_alloc();
+    return (ptr);
+  }
+
+  void *globalAllocNoThrow(std::size_t const size, std::size_t const alignment) noexcept
+  {
+    try
+    {
+      return (globalAlloc(size, alignment));
+    }
+    catch (std::bad_alloc const &)
+    {
+      return (nullptr);
+    }
+  }
+
+  void globalFree(void *ptr) noexcept
+  {
+    std::uintptr_t *header = (std::uintptr_t *) ptr;
+
+    if (ptr == nullptr)
+      return;
+    if (header[-1] == 0)
+      std::free((void *) header[-2]);
+    else
+      t_global_allocator::free(ptr);
+  }
+};
+
+void *operator new(std::size_t size)
+{
+  return (globalAlloc(size, GLOBAL_NEW_ALIGN_SIZE));
+}
+
+void *operator new[](std::size_t size)
+{
+  return (globalAlloc(size, GLOBAL_NEW_ALIGN_SIZE));
+}
+
+void *operator new(std::size_t size, std::nothrow_t const &) noexcept
+{
+  return (globalAllocNoThrow(size, GLOBAL_NEW_ALIGN_SIZE));
+}
+
+void *operator new[](std::size_t size, std::nothrow_t const &) noexcept
+{
+  return (globalAllocNoThrow(size, GLOBAL_NEW_ALIGN_SIZE));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+  return (globalAlloc(size, MAX((std::size_t) alignment, GLOBAL_NEW_ALIGN_SIZE)));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return (globalAlloc(size, MAX((std::size_t) alignment, GLOBAL_NEW_ALIGN_SIZE)));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, std::nothrow_t const &) noexcept
+{
+  return (globalAllocNoThrow(size, MAX((std::size_t) alignment, GLOBAL_NEW_ALIGN_SIZE)));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, std::nothrow_t const &) noexcept
+{
+  return (globalAllocNoThrow(size, MAX((std::size_t) alignment, GLOBAL_NEW_ALIGN_SIZE)));
+}
+
+void operator delete(void *ptr) noexcept
+{
+  globalFree(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  globalFree(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+  globalFree(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+  globalFree(ptr);
+}
+
+void operator delete(void *ptr, std::nothrow_t const &) noexcept
+{
+  globalFree(ptr);
+}
+
+void operator delete[](void *ptr, std::nothrow_t const &) noexcept
+{
+  globalFree(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+  globalFree(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+  globalFree(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+  globalFree(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept
+{
+  globalFree(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, std::nothrow_t const &) noexcept
+{
+  globalFree(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, std::nothrow_t const &) noexcept
+{
+  globalFree(ptr);
+}
\ No newline at end of file
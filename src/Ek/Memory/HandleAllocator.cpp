@@ -0,0 +1,213 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <cstdlib>
+#include <cstring>
+
+#include "Ek/Memory/HandleAllocator.hpp"
+#include "Ek/Utils/Logger.hpp"
+
+/* End of the free entries list */
+#define HANDLE_ENTRY_NONE 0xFFFFFFFF
+
+/* Blocks moved between two looks at the clock */
+#define HANDLE_COMPACT_STEPS 16
+
+namespace ek
+{
+  HandleAllocator::HandleAllocator(std::uint64_t capacity, std::uint32_t maxHandles) :
+    _capacity(ALIGN(capacity, DEFAULT_ALIGN_SIZE)),
+    _headerSize(ALIGN(sizeof(t_handle_block), DEFAULT_ALIGN_SIZE)),
+    _maxHandles(maxHandles),
+    _top(0),
+    _freeSize(0),
+    _compactRead(0),
+    _compactWrite(0),
+    _firstFreeEntry(0)
+  {
+    DEBUG("HandleAllocator: Constructor");
+    this->_heap = (char *) std::malloc(this->_capacity);
+    this->_entries = (t_handle_entry *) std::malloc(sizeof(t_handle_entry) * this->_maxHandles);
+    if (this->_heap == nullptr || this->_entries == nullptr)
+    {
+      std::free(this->_heap);
+      std::free(this->_entries);
+      throw std::bad_alloc();
+    }
+    for (std::uint32_t i = 0; i < this->_maxHandles; i++)
+    {
+      this->_entries[i].offset = 0;
+      this->_entries[i].generation = 1;
+      this->_entries[i].nextFree = (i + 1 < this->_maxHandles) ? i + 1 : HANDLE_ENTRY_NONE;
+    }
+  }
+
+  HandleAllocator::~HandleAllocator()
+  {
+    DEBUG("HandleAllocator: Destructor");
+    /* Mid-pass, the gap between the compaction cursors holds nothing */
+    if (this->_top - this->_freeSize - (this->_compactRead - this->_compactWrite) != 0)
+      WARN("HandleAllocator: Memory leaks detected!");
+    std::free(this->_heap);
+    std::free(this->_entries);
+  }
+
+  HandleAllocator::t_handle_entry *HandleAllocator::_entry(std::uint32_t const index, std::uint32_t const generation) const
+  {
+    if (index >= this->_maxHandles || this->_entries[index].generation != generation)
+      return (nullptr);
+    return (&this->_entries[index]);
+  }
+
+  bool HandleAllocator::_compactStep()
+  {
+    t_handle_block *block;
+
+    if (this->_compactRead == this->_top)
+    {
+      /* End of the pass: the holes left behind are now above the top */
+      this->_top = this->_compactWrite;
+      this->_compactRead = 0;
+      this->_compactWrite = 0;
+      return (false);
+    }
+    block = (t_handle_block *) (this->_heap + this->_compactRead);
+    if (block->free)
+      this->_freeSize -= block->size;
+    else
+    {
+      if (this->_compactWrite != this->_compactRead)
+      {
+        std::memmove(this->_heap + this->_compactWrite, block, block->size);
+        block = (t_handle_block *) (this->_heap + this->_compactWrite);
+        this->_entries[block->index].offset = this->_compactWrite + this->_headerSize;
+      }
+      this->_compactWrite += block->size;
+    }
+    this->_compactRead += block->size;
+    return (true);
+  }
+
+  HandleAllocator::Handle HandleAllocator::allocate(std::uint64_t const size)
+  {
+    std::uint64_t blockSize = ALIGN(size, DEFAULT_ALIGN_SIZE) + this->_headerSize;
+    t_handle_block *block;
+    t_handle_entry *entry;
+    Handle handle;
+
+    /* Out of room: the heap is compacted at once, as long as there are holes left or a pass is pending */
+    while (this->_top + blockSize > this->_capacity && (this->_freeSize > 0 || this->_compactRead != 0))
+    {
+      DEBUG("HandleAllocator: Full compaction");
+      while (this->_compactStep());
+    }
+    if (this->_top + blockSize > this->_capacity)
+    {
+      ERROR("HandleAllocator: A block of " << size << " bytes has been asked; heap space left: " << (this->_capacity - this->_top) << " bytes.");
+      throw std::bad_alloc();
+    }
+    if (this->_firstFreeEntry == HANDLE_ENTRY_NONE)
+    {
+      ERROR("HandleAllocator: All the " << this->_maxHandles << " handles are in use.");
+      throw std::bad_alloc();
+    }
+
+    handle.index = this->_firstFreeEntry;
+    entry = &this->_entries[handle.index];
+    handle.generation = entry->generation;
+    this->_firstFreeEntry = entry->nextFree;
+
+    block = (t_handle_block *) (this->_heap + this->_top);
+    block->size = blockSize;
+    block->index = handle.index;
+    block->free = false;
+    entry->offset = this->_top + this->_headerSize;
+    this->_top += blockSize;
+    return (handle);
+  }
+
+  void HandleAllocator::free(Handle const handle)
+  {
+    t_handle_entry *entry = this->_entry(handle.index, handle.generation);
+    t_handle_block *block;
+
+    if (entry == nullptr)
+    {
+      WARN("HandleAllocator: Free of a stale handle (" << handle.index << ", " << handle.generation << ")");
+      return;
+    }
+    block = (t_handle_block *) (this->_heap + entry->offset - this->_headerSize);
+    block->free = true;
+    this->_freeSize += block->size;
+
+    /* Old handles to this entry become stale */
+    entry->generation = (entry->generation == 0xFFFFFFFF) ? 1 : entry->generation + 1;
+    entry->nextFree = this->_firstFreeEntry;
+    this->_firstFreeEntry = handle.index;
+  }
+
+  void *HandleAllocator::get(Handle const handle) const
+  {
+    t_handle_entry *entry = this->_entry(handle.index, handle.generation);
+
+    if (entry == nullptr)
+      return (nullptr);
+    return (this->_heap + entry->offset);
+  }
+
+  bool HandleAllocator::isValid(Handle const handle) const
+  {
+    return (this->_entry(handle.index, handle.generation) != nullptr);
+  }
+
+  bool HandleAllocator::defragment(std::chrono::nanoseconds const budget)
+  {
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + budget;
+    unsigned int steps = 0;
+
+    while (this->_freeSize > 0 || this->_compactRead != 0)
+    {
+      if (!this->_compactStep() && this->_freeSize == 0)
+        break;
+      if (++steps % HANDLE_COMPACT_STEPS == 0 && std::chrono::steady_clock::now() >= end)
+        return (false);
+    }
+    return (true);
+  }
+
+  std::uint64_t HandleAllocator::getCapacity() const
+  {
+    return (this->_capacity);
+  }
+
+  std::uint64_t HandleAllocator::getUsedSize() const
+  {
+    return (this->_top);
+  }
+
+  std::uint64_t HandleAllocator::getFreeSize() const
+  {
+    /* Mid-pass, the gap between the compaction cursors is free too */
+    return (this->_freeSize + (this->_compactRead - this->_compactWrite));
+  }
+};
\ No newline at end of file
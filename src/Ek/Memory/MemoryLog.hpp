@@ -0,0 +1,46 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#pragma once
+
+#include "Ek/Utils/Logger.hpp"
+
+/*
+** Statements of the allocators operator new goes through. Once EK_OVERRIDE_NEW
+** routes operator new to them, the logger, which allocates, would call back
+** into them: debug statements are left out, and errors are written to stderr
+** as a fixed message.
+*/
+#ifdef EK_OVERRIDE_NEW
+  #include <unistd.h>
+
+  #define MEMORY_DEBUG(Stream) ((void) 0)
+  #if EK_LOG_LEVEL >= LOG_LEVEL_ERROR
+    #define MEMORY_ERROR(Message, Stream) ((void) !write(2, "ERR " Message "\n", sizeof("ERR " Message "\n") - 1))
+  #else
+    #define MEMORY_ERROR(Message, Stream) ((void) 0)
+  #endif
+#else
+  #define MEMORY_DEBUG(Stream) DEBUG(Stream)
+  #define MEMORY_ERROR(Message, Stream) ERROR(Stream)
+#endif
\ No newline at end of file
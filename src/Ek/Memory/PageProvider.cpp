@@ -0,0 +1,227 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <cstdlib>
+
+#include "Ek/Memory/PageProvider.hpp"
+#include "Ek/Utils/Config.hpp"
+#include "Ek/Utils/Maths.hpp"
+#include "Ek/Utils/Logger.hpp"
+
+#if defined(EK_SYSTEM_UNIX) || defined(EK_SYSTEM_MACOS)
+  #include <sys/mman.h>
+  #define EK_PAGE_PROVIDER_MMAP
+#endif
+
+/* Smallest page the system can give back */
+#define SYSTEM_PAGE_SIZE 4096
+
+namespace ek
+{
+  PageProvider::PageProvider(std::uint64_t pageSize, std::uint64_t reserveSize, std::uint64_t flags, std::uint64_t cacheSize) :
+    _pageSize(SYSTEM_PAGE_SIZE),
+    _flags(flags),
+    _cachedSize(0),
+    _top(nullptr),
+    _end(nullptr)
+  {
+    DEBUG("PageProvider: Constructor");
+    while (this->_pageSize < pageSize)
+      this->_pageSize <<= 1;
+    this->_rangeAlign = this->_pageSize;
+    if (flags & (PAGE_PROVIDER_HUGE_PAGES | PAGE_PROVIDER_HUGE_TLB))
+      this->_rangeAlign = MAX(this->_pageSize, HUGE_PAGE_SIZE);
+    this->_reserveSize = ALIGN(MAX(reserveSize, this->_rangeAlign), this->_rangeAlign);
+    this->_cacheSize = cacheSize * this->_pageSize;
+  }
+
+  PageProvider::~PageProvider()
+  {
+    DEBUG("PageProvider: Destructor");
+    for (t_page_block const &range : this->_ranges)
+      this->_unreserve(range.ptr, range.size);
+  }
+
+  char *PageProvider::_reserve(std::uint64_t const size)
+  {
+#if defined(EK_PAGE_PROVIDER_MMAP)
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    std::uintptr_t aligned;
+    char *ptr;
+
+  #if defined(MAP_NORESERVE)
+    flags |= MAP_NORESERVE;
+  #endif
+  #if defined(MAP_HUGETLB)
+    if (this->_flags & PAGE_PROVIDER_HUGE_TLB)
+    {
+      ptr = (char *) mmap(nullptr, size, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+      if (ptr != MAP_FAILED)
+      {
+        DEBUG("PageProvider: mmap(" << size << ", MAP_HUGETLB)");
+        return (ptr);
+      }
+      WARN("PageProvider: No huge pages available, falling back to normal pages");
+      this->_flags &= ~PAGE_PROVIDER_HUGE_TLB;
+    }
+  #endif
+
+    /* Over-reserve, then trim so the range starts on an aligned address */
+    DEBUG("PageProvider: mmap(" << size << ")");
+    ptr = (char *) mmap(nullptr, size + this->_rangeAlign, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (ptr == MAP_FAILED)
+      return (nullptr);
+    aligned = ALIGN((std::uintptr_t) ptr, this->_rangeAlign);
+    if (aligned != (std::uintptr_t) ptr)
+      munmap(ptr, aligned - (std::uintptr_t) ptr);
+    munmap((char *) aligned + size, ((std::uintptr_t) ptr + this->_rangeAlign) - aligned);
+  #if defined(MADV_HUGEPAGE)
+    if (this->_flags & PAGE_PROVIDER_HUGE_PAGES)
+      madvise((char *) aligned, size, MADV_HUGEPAGE);
+  #endif
+    return ((char *) aligned);
+#else
+    DEBUG("PageProvider: aligned_alloc(" << size << ")");
+    return ((char *) std::aligned_alloc(this->_rangeAlign, size));
+#endif
+  }
+
+  void PageProvider::_unreserve(char *ptr, std::uint64_t const size)
+  {
+#if defined(EK_PAGE_PROVIDER_MMAP)
+    DEBUG("PageProvider: munmap(" << (void *) ptr << ", " << size << ")");
+    munmap(ptr, size);
+#else
+    DEBUG("PageProvider: free(" << (void *) ptr << ")");
+    (void) size;
+    std::free(ptr);
+#endif
+  }
+
+  void PageProvider::_decommit(char *ptr, std::uint64_t const size)
+  {
+#if defined(EK_PAGE_PROVIDER_MMAP) && defined(MADV_DONTNEED)
+    madvise(ptr, size, MADV_DONTNEED);
+#else
+    (void) ptr;
+    (void) size;
+#endif
+  }
+
+  bool PageProvider::_popBlock(std::vector<t_page_block> &blocks, std::uint64_t const size, char **ptr)
+  {
+    std::uint64_t found = blocks.size();
+
+    /* Exact fit first, else the first bigger block is split */
+    for (std::uint64_t i = 0; i < blocks.size(); i++)
+      if (blocks[i].size == size)
+      {
+        *ptr = blocks[i].ptr;
+        blocks[i] = blocks.back();
+        blocks.pop_back();
+        return (true);
+      }
+      else if (blocks[i].size > size && found == blocks.size())
+        found = i;
+    if (found == blocks.size())
+      return (false);
+    *ptr = blocks[found].ptr;
+    blocks[found].ptr += size;
+    blocks[found].size -= size;
+    return (true);
+  }
+
+  void *PageProvider::allocate(std::uint64_t const size)
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    std::uint64_t blockSize = ALIGN(size, this->_pageSize);
+    std::uint64_t rangeSize;
+    char *ptr;
+
+    if (this->_popBlock(this->_cache, blockSize, &ptr))
+    {
+      this->_cachedSize -= blockSize;
+      return (ptr);
+    }
+    if (this->_popBlock(this->_decommitted, blockSize, &ptr))
+      return (ptr);
+    if (this->_top + blockSize > this->_end)
+    {
+      rangeSize = MAX(this->_reserveSize, ALIGN(blockSize, this->_rangeAlign));
+      ptr = this->_reserve(rangeSize);
+      if (ptr == nullptr)
+      {
+        ERROR("PageProvider: Cannot reserve " << rangeSize << " bytes");
+        throw std::bad_alloc();
+      }
+      /* The tail of the previous range has never been touched: keep it for later */
+      if (this->_top != this->_end)
+        this->_decommitted.push_back({ this->_top, (std::uint64_t) (this->_end - this->_top) });
+      this->_ranges.push_back({ ptr, rangeSize });
+      this->_top = ptr;
+      this->_end = ptr + rangeSize;
+    }
+    ptr = this->_top;
+    this->_top += blockSize;
+    return (ptr);
+  }
+
+  void PageProvider::free(void *ptr, std::uint64_t const size)
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    std::uint64_t blockSize = ALIGN(size, this->_pageSize);
+
+    if (this->_cachedSize + blockSize <= this->_cacheSize)
+    {
+      this->_cache.push_back({ (char *) ptr, blockSize });
+      this->_cachedSize += blockSize;
+    }
+    else
+    {
+      this->_decommit((char *) ptr, blockSize);
+      this->_decommitted.push_back({ (char *) ptr, blockSize });
+    }
+  }
+
+  std::uint64_t PageProvider::getPageSize() const
+  {
+    return (this->_pageSize);
+  }
+
+  std::uint64_t PageProvider::getReservedSize()
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    std::uint64_t size = 0;
+
+    for (t_page_block const &range : this->_ranges)
+      size += range.size;
+    return (size);
+  }
+
+  std::uint64_t PageProvider::getCachedSize()
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+
+    return (this->_cachedSize);
+  }
+};
\ No newline at end of file
@@ -0,0 +1,211 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <cstdlib>
+
+#include "Ek/Memory/PoolAllocator.hpp"
+#include "Ek/Utils/Maths.hpp"
+#include "Ek/Memory/MemoryLog.hpp"
+
+namespace ek
+{
+  PoolAllocator::PoolAllocator(std::uint64_t pageSize, std::uint64_t maxSize, PageProvider *provider) :
+    _headerPageSize(ALIGN(sizeof(t_pool_page), CACHE_LINE_SIZE)),
+    _pageSize(DEFAULT_ALIGN_SIZE),
+    _maxSize(ALIGN(MIN(maxSize, POOL_MAX_SIZE_LIMIT), DEFAULT_ALIGN_SIZE)),
+    _classCount(0),
+    _provider(provider),
+    _pages(nullptr)
+  {
+    std::uint64_t size;
+    std::uint64_t step;
+    std::uint64_t index;
+
+    MEMORY_DEBUG("PoolAllocator: Constructor");
+
+    /* Pages are aligned on their size, so free() can find the page header of any slot */
+    pageSize = MAX(pageSize, this->_maxSize * 4);
+    while (this->_pageSize < pageSize)
+      this->_pageSize <<= 1;
+    if (provider && provider->getPageSize() != this->_pageSize)
+    {
+      MEMORY_ERROR("PoolAllocator: The page provider does not use the pool page size", "PoolAllocator: The page provider must use pages of " << this->_pageSize << " bytes");
+      throw std::bad_alloc();
+    }
+
+    /* Size classes: 16 bytes steps up to 128, then 4 classes per power of two */
+    size = sizeof(t_pool_slot);
+    step = sizeof(t_pool_slot);
+    while (this->_classCount < POOL_MAX_CLASSES)
+    {
+      if (size >= this->_maxSize)
+        size = MAX(this->_maxSize, sizeof(t_pool_slot));
+      this->_classes[this->_classCount].slotSize = size;
+      this->_classes[this->_classCount].slotCount = (this->_pageSize - this->_headerPageSize) / size;
+      this->_classes[this->_classCount].currentSlot = nullptr;
+      this->_classCount++;
+      if (size >= this->_maxSize)
+        break;
+      if (size >= 128 && (size & (size - 1)) == 0)
+        step = size / 4;
+      size += step;
+    }
+
+    index = 0;
+    for (std::uint64_t i = 0; i <= this->_maxSize / DEFAULT_ALIGN_SIZE; i++)
+    {
+      while (this->_classes[index].slotSize < i * DEFAULT_ALIGN_SIZE)
+        index++;
+      this->_lookup[i] = (std::uint8_t) index;
+    }
+  }
+
+  PoolAllocator::~PoolAllocator()
+  {
+    t_pool_page *page;
+
+    MEMORY_DEBUG("PoolAllocator: Destructor");
+    while (this->_pages)
+    {
+      page = this->_pages->next;
+      this->_systemFree(this->_pages, this->_pageSize);
+      this->_pages = page;
+    }
+  }
+
+  void *PoolAllocator::_systemAlloc(std::uint64_t const size)
+  {
+    void *ptr;
+
+    if (this->_provider)
+      return (this->_provider->allocate(size));
+    MEMORY_DEBUG("PoolAllocator: aligned_alloc(" << size << ")");
+    ptr = std::aligned_alloc(this->_pageSize, size);
+    if (ptr == nullptr)
+      throw std::bad_alloc();
+    return (ptr);
+  }
+
+  void PoolAllocator::_systemFree(void *ptr, std::uint64_t const size)
+  {
+    if (this->_provider)
+      this->_provider->free(ptr, size);
+    else
+    {
+      MEMORY_DEBUG("PoolAllocator: free(" << ptr << ")");
+      std::free(ptr);
+    }
+  }
+
+  void PoolAllocator::_pageAlloc(std::uint64_t const index)
+  {
+    t_pool_page *page;
+    t_pool_class *poolClass = &this->_classes[index];
+
+    page = (t_pool_page *) this->_systemAlloc(this->_pageSize);
+    page->next = this->_pages;
+    page->classIndex = index;
+    this->_pages = page;
+    poolClass->currentSlot = (t_pool_slot *) (((char *) page) + this->_headerPageSize);
+    poolClass->currentSlot->size = poolClass->slotCount;
+    poolClass->currentSlot->next = nullptr;
+  }
+
+  void *PoolAllocator::_slotAlloc(t_pool_class *poolClass)
+  {
+    t_pool_slot *current;
+    t_pool_slot *next;
+
+    current = poolClass->currentSlot;
+    if (current->size > 1)
+    {
+      next = (t_pool_slot *) (((char *) current) + poolClass->slotSize);
+      next->size = current->size - 1;
+      next->next = current->next;
+      poolClass->currentSlot = next;
+    }
+    else
+      poolClass->currentSlot = current->next;
+    return ((void *) current);
+  }
+
+  void *PoolAllocator::allocate(std::uint64_t const size)
+  {
+    std::uint64_t index;
+
+    if (size > this->_maxSize)
+    {
+      MEMORY_ERROR("PoolAllocator: A block bigger than the max pool size has been asked", "PoolAllocator: A block of " << size << " bytes has been asked; max pool size available: " << this->_maxSize << " bytes.");
+      throw std::bad_alloc();
+    }
+    index = this->_lookup[(size + (DEFAULT_ALIGN_SIZE - 1)) / DEFAULT_ALIGN_SIZE];
+    if (!this->_classes[index].currentSlot)
+      this->_pageAlloc(index);
+    return (this->_slotAlloc(&this->_classes[index]));
+  }
+
+  void *PoolAllocator::allocate(std::uint64_t const size, std::uint64_t const alignment)
+  {
+    std::uint64_t index;
+
+    if (alignment <= DEFAULT_ALIGN_SIZE)
+      return (this->allocate(size));
+    if (size > this->_maxSize || alignment > CACHE_LINE_SIZE)
+    {
+      MEMORY_ERROR("PoolAllocator: A block bigger than the max pool size or alignment has been asked", "PoolAllocator: A block of " << size << " bytes aligned on " << alignment << " bytes has been asked; max pool size available: " << this->_maxSize << " bytes, max alignment: " << CACHE_LINE_SIZE << " bytes.");
+      throw std::bad_alloc();
+    }
+
+    /* Pages and their header are aligned on a cache line: a class is aligned on the biggest power of two dividing its slot size */
+    index = this->_lookup[(size + (DEFAULT_ALIGN_SIZE - 1)) / DEFAULT_ALIGN_SIZE];
+    while (index < this->_classCount && POW2_DIVISOR(this->_classes[index].slotSize) < alignment)
+      index++;
+    if (index == this->_classCount)
+    {
+      MEMORY_ERROR("PoolAllocator: No size class for an aligned block", "PoolAllocator: No size class of " << size << " bytes aligned on " << alignment << " bytes.");
+      throw std::bad_alloc();
+    }
+    if (!this->_classes[index].currentSlot)
+      this->_pageAlloc(index);
+    return (this->_slotAlloc(&this->_classes[index]));
+  }
+
+  void PoolAllocator::free(void *ptr)
+  {
+    t_pool_page *page;
+    t_pool_class *poolClass;
+    t_pool_slot *slot;
+
+    page = (t_pool_page *) (((std::uintptr_t) ptr) & ~(this->_pageSize - 1));
+    poolClass = &this->_classes[page->classIndex];
+    slot = (t_pool_slot *) ptr;
+    slot->size = 1;
+    slot->next = poolClass->currentSlot;
+    poolClass->currentSlot = slot;
+  }
+
+  std::uint64_t PoolAllocator::getMaxSize() const
+  {
+    return (this->_maxSize);
+  }
+};
\ No newline at end of file
@@ -22,14 +22,18 @@
 // 
 
 #include "Ek/Memory/StackAllocator.hpp"
+#include "Ek/Memory/AllocationTracer.hpp"
+#include "Ek/Utils/Maths.hpp"
 #include "Ek/Utils/Logger.hpp"
 
 namespace ek
 {
-  StackAllocator::StackAllocator(std::uint64_t pageSize) :
+  StackAllocator::StackAllocator(std::uint64_t pageSize, PageProvider *provider) :
     _pageSize(pageSize),
     _pageHeaderSize(ALIGN(sizeof(t_stack_page), DEFAULT_ALIGN_SIZE)),
-    _slotHeaderSize(ALIGN(sizeof(t_stack_slot), DEFAULT_ALIGN_SIZE))
+    _slotHeaderSize(ALIGN(sizeof(t_stack_slot), DEFAULT_ALIGN_SIZE)),
+    _provider(provider),
+    _pageCount(0)
   {
     DEBUG("StackAllocator: Constructor");
     this->_currentPage = (t_stack_page *) this->_systemAlloc(this->_pageSize);
@@ -48,41 +52,73 @@ namespace ek
     DEBUG("StackAllocator: Destructor");
     if (this->_currentPage->last != nullptr ||
         this->_currentPage->top->last != nullptr)
+    {
       WARN("StackAllocator: Memory leaks detected!");
-    page = this->_currentPage->last;
-    this->_systemFree(this->_currentPage);
-    while (page)
+#if defined(EK_ALLOCATION_TRACING)
+      AllocationTracer::report(Logger::warn_stream());
+      for (t_stack_page *page = this->_currentPage; page; page = page->last)
+        TRACE_FREE_RANGE(page, ((char *) page) + page->size);
+#endif
+    }
+    if (this->_currentPage->next)
+      this->_systemFree(this->_currentPage->next, this->_currentPage->next->size);
+    while (this->_currentPage)
     {
-      this->_currentPage = page;
       page = this->_currentPage->last;
-      this->_systemFree(this->_currentPage);
+      this->_systemFree(this->_currentPage, this->_currentPage->size);
+      this->_currentPage = page;
     }
   }
 
   void *StackAllocator::_systemAlloc(std::uint64_t const size)
   {
-    DEBUG("StackAllocator: malloc(" << size << ")");
-    return (std::malloc(size));
+    void *ptr;
+
+    if (this->_provider)
+      ptr = this->_provider->allocate(size);
+    else
+    {
+      DEBUG("StackAllocator: malloc(" << size << ")");
+      ptr = std::malloc(size);
+      if (ptr == nullptr)
+        throw std::bad_alloc();
+    }
+    this->_pageCount++;
+    return (ptr);
   }
 
-  void StackAllocator::_systemFree(void *ptr)
+  void StackAllocator::_systemFree(void *ptr, std::uint64_t const size)
   {
-    DEBUG("StackAllocator: free(0x" << ptr << ")");
-    std::free(ptr);
+    this->_pageCount--;
+    if (this->_provider)
+      this->_provider->free(ptr, size);
+    else
+    {
+      DEBUG("StackAllocator: free(" << ptr << ")");
+      std::free(ptr);
+    }
   }
 
-  void StackAllocator::_pageAlloc(std::uint64_t const size) throw()
+  void StackAllocator::_pageAlloc(std::uint64_t const size)
   {
-    std::uint64_t pageSize = ALIGN(size + this->_pageHeaderSize, this->_pageSize);
-    t_stack_page *page = (t_stack_page *) this->_systemAlloc(pageSize);
+    std::uint64_t pageSize = ALIGN(size + this->_pageHeaderSize + this->_slotHeaderSize, this->_pageSize);
+    t_stack_page *page = this->_currentPage->next;
 
+    /* The spare page left by the last _pageFree() is reused when big enough */
+    if (page != nullptr && page->size < pageSize)
+    {
+      this->_systemFree(page, page->size);
+      page = nullptr;
+    }
     if (page == nullptr)
-      throw std::bad_alloc();
+    {
+      page = (t_stack_page *) this->_systemAlloc(pageSize);
+      page->size = pageSize;
+    }
     this->_currentPage->next = page;
     page->last = this->_currentPage;
     page->next = nullptr;
-    page->size = pageSize;
-    page->top = (t_stack_slot *) (((char *) this->_currentPage) + ALIGN(sizeof(t_stack_page), DEFAULT_ALIGN_SIZE));
+    page->top = (t_stack_slot *) (((char *) page) + this->_pageHeaderSize);
     page->top->last = nullptr;
     page->top->free = true;
     this->_currentPage = page;
@@ -92,23 +128,32 @@ namespace ek
   {
     t_stack_page *page = this->_currentPage;
 
-    DEBUG("StackAllocator: Freeing page");
+    TRACE("StackAllocator: Freeing page");
     if (page->last != nullptr)
     {
+      /* Keep the page as spare so a stack going back and forth over the boundary does not thrash */
+      if (page->next != nullptr)
+      {
+        this->_systemFree(page->next, page->next->size);
+        page->next = nullptr;
+      }
       this->_currentPage = page->last;
-      this->_systemFree(page);
     }
   }
 
-  void *StackAllocator::_slotAlloc(std::uint64_t const size) throw()
+  void *StackAllocator::_slotAlloc(std::uint64_t const size, std::uint64_t const alignment)
   {
+    t_stack_slot *top = this->_currentPage->top;
     t_stack_slot *slot;
-    void *ptr;
+    char *ptr;
 
-    slot = this->_currentPage->top;
+    /* An over-aligned slot header is moved up against its data, the padding under it is lost until the slot is freed */
+    ptr = (char *) ALIGN(((std::uintptr_t) top) + this->_slotHeaderSize, alignment);
+    slot = (t_stack_slot *) (ptr - this->_slotHeaderSize);
+    if (slot != top)
+      slot->last = top->last;
     slot->free = false;
-    ptr = ((char *) slot) + this->_slotHeaderSize;
-    this->_currentPage->top = (t_stack_slot *) (((char *) slot) + size);
+    this->_currentPage->top = (t_stack_slot *) (ptr + size);
     this->_currentPage->top->last = slot;
     this->_currentPage->top->free = true;
     return (ptr);
@@ -116,30 +161,44 @@ namespace ek
 
   void StackAllocator::_slotFree(t_stack_slot *top)
   {
+    t_stack_slot *last;
+
+    /* Pops every freed slot under the top, going down through pages */
     this->_currentPage->top = top;
-    while (this->_currentPage->top->last != nullptr &&
-           this->_currentPage->top->free)
+    while (true)
+    {
+      last = this->_currentPage->top->last;
+      if (last != nullptr)
       {
-        this->_currentPage->top = this->_currentPage->top->last;
-        if (this->_currentPage->top->last == nullptr &&
-            this->_currentPage->top->free)
-          this->_pageFree();
+        if (!last->free)
+          break;
+        this->_currentPage->top = last;
       }
+      else if (this->_currentPage->last != nullptr)
+        this->_pageFree();
+      else
+        break;
+    }
   }
 
-  void *StackAllocator::allocate(std::uint64_t const size) throw()
+  TRACE_ALLOCATOR_CODE void *StackAllocator::allocate(std::uint64_t const size)
   {
-    std::uint64_t slotSize = ALIGN(size, DEFAULT_ALIGN_SIZE) + this->_slotHeaderSize;
-    void *ptr;
+    return (this->allocate(size, DEFAULT_ALIGN_SIZE));
+  }
 
-    if (((char *) this->_currentPage->top) + slotSize + this->_slotHeaderSize >= ((char *) this->_currentPage) + this->_currentPage->size)
+  TRACE_ALLOCATOR_CODE void *StackAllocator::allocate(std::uint64_t const size, std::uint64_t const alignment)
+  {
+    std::uint64_t dataSize = ALIGN(size, DEFAULT_ALIGN_SIZE);
+    std::uint64_t dataAlign = MAX(alignment, DEFAULT_ALIGN_SIZE);
+    char *ptr = (char *) ALIGN(((std::uintptr_t) this->_currentPage->top) + this->_slotHeaderSize, dataAlign);
+
+    if (ptr + dataSize + this->_slotHeaderSize > ((char *) this->_currentPage) + this->_currentPage->size)
     {
-      DEBUG("StackAllocator: Page size exceeded");
-      this->_pageAlloc(slotSize);
-      ptr = this->_slotAlloc(slotSize);
+      TRACE("StackAllocator: Page size exceeded");
+      this->_pageAlloc(dataSize + this->_slotHeaderSize + (dataAlign - DEFAULT_ALIGN_SIZE));
     }
-    else
-      ptr = this->_slotAlloc(slotSize);
+    ptr = (char *) this->_slotAlloc(dataSize, dataAlign);
+    TRACE_ALLOCATE(ptr, size);
     return (ptr);
   }
 
@@ -147,8 +206,46 @@ namespace ek
   {
     t_stack_slot *slot = (t_stack_slot *) (((char *) ptr) - this->_slotHeaderSize);
 
+    TRACE_FREE(ptr);
     slot->free = true;
     if (this->_currentPage->top->last == slot)
       this->_slotFree(slot);
   }
+
+  StackAllocator::Marker StackAllocator::getMarker() const
+  {
+    Marker marker = { this->_currentPage, this->_currentPage->top, this->_currentPage->top->last };
+
+    return (marker);
+  }
+
+  void StackAllocator::freeToMarker(Marker const &marker)
+  {
+#if defined(EK_ALLOCATION_TRACING)
+    for (t_stack_page *page = this->_currentPage; page != marker.page; page = page->last)
+      TRACE_FREE_RANGE(page, ((char *) page) + page->size);
+    TRACE_FREE_RANGE(marker.top, marker.page->top);
+#endif
+    while (this->_currentPage != marker.page)
+      this->_pageFree();
+    marker.top->last = marker.last;
+    marker.top->free = true;
+    this->_slotFree(marker.top);
+  }
+
+  std::uint64_t StackAllocator::getPageCount() const
+  {
+    return (this->_pageCount);
+  }
+
+  StackScope::StackScope(StackAllocator &allocator) :
+    _allocator(allocator),
+    _marker(allocator.getMarker())
+  {
+  }
+
+  StackScope::~StackScope()
+  {
+    this->_allocator.freeToMarker(this->_marker);
+  }
 };
\ No newline at end of file
@@ -0,0 +1,201 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <cstdlib>
+
+#include "Ek/Memory/ThreadAllocator.hpp"
+#include "Ek/Memory/AllocationTracer.hpp"
+#include "Ek/Memory/FrameAllocator.hpp"
+#include "Ek/Memory/StackAllocator.hpp"
+#include "Ek/Memory/PoolAllocator.hpp"
+#include "Ek/Utils/Maths.hpp"
+#include "Ek/Memory/MemoryLog.hpp"
+
+/* Owner word flag: the block is preceded by padding */
+#define THREAD_BLOCK_PADDED 0x1
+
+namespace ek
+{
+  template <typename Alloc>
+  std::mutex ThreadAllocator<Alloc>::_instancesMutex;
+
+  template <typename Alloc>
+  ThreadAllocator<Alloc> *ThreadAllocator<Alloc>::_instances = nullptr;
+
+  template <typename Alloc>
+  thread_local typename ThreadAllocator<Alloc>::t_thread_local ThreadAllocator<Alloc>::_local = { nullptr, false };
+
+  template <typename Alloc>
+  ThreadAllocator<Alloc>::s_thread_local::~s_thread_local()
+  {
+    if (this->instance)
+      ThreadAllocator<Alloc>::_release(this->instance);
+    this->instance = nullptr;
+    this->exiting = true;
+  }
+
+  template <typename Alloc>
+  ThreadAllocator<Alloc>::ThreadAllocator() :
+    _allocator(),
+    _headerSize(ALIGN(sizeof(t_thread_block), DEFAULT_ALIGN_SIZE)),
+    _abandoned(false),
+    _nextInstance(nullptr),
+    _remoteBlocks(nullptr)
+  {
+  }
+
+  /* Frame slots are grown by 16 bytes: a thread still gets DEFAULT_FRAME_SLOT_SIZE bytes, aligned on 16 bytes at most */
+  template <>
+  ThreadAllocator<FrameAllocator>::ThreadAllocator() :
+    _allocator(DEFAULT_PAGE_SIZE, DEFAULT_FRAME_SLOT_SIZE + DEFAULT_ALIGN_SIZE * 2),
+    _headerSize(ALIGN(sizeof(t_thread_block), DEFAULT_ALIGN_SIZE)),
+    _abandoned(false),
+    _nextInstance(nullptr),
+    _remoteBlocks(nullptr)
+  {
+  }
+
+  template <typename Alloc>
+  ThreadAllocator<Alloc>::~ThreadAllocator()
+  {
+  }
+
+  template <typename Alloc>
+  ThreadAllocator<Alloc> *ThreadAllocator<Alloc>::_acquire()
+  {
+    std::lock_guard<std::mutex> lock(_instancesMutex);
+    ThreadAllocator *instance;
+    void *ptr;
+
+    for (instance = _instances; instance; instance = instance->_nextInstance)
+      if (instance->_abandoned)
+      {
+        MEMORY_DEBUG("ThreadAllocator: Adopting an abandoned instance");
+        instance->_abandoned = false;
+        return (instance);
+      }
+
+    MEMORY_DEBUG("ThreadAllocator: New thread instance");
+    ptr = std::aligned_alloc(CACHE_LINE_SIZE, ALIGN(sizeof(ThreadAllocator), CACHE_LINE_SIZE));
+    if (ptr == nullptr)
+      throw std::bad_alloc();
+    instance = new (ptr) ThreadAllocator();
+    instance->_nextInstance = _instances;
+    _instances = instance;
+    return (instance);
+  }
+
+  template <typename Alloc>
+  void ThreadAllocator<Alloc>::_release(ThreadAllocator *instance)
+  {
+    std::lock_guard<std::mutex> lock(_instancesMutex);
+
+    MEMORY_DEBUG("ThreadAllocator: Abandoning a thread instance");
+    instance->_abandoned = true;
+  }
+
+  template <typename Alloc>
+  void ThreadAllocator<Alloc>::_remoteFree(t_thread_block *block)
+  {
+    t_thread_block *head = this->_remoteBlocks.load(std::memory_order_relaxed);
+
+    do
+      block->next = head;
+    while (!this->_remoteBlocks.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  template <typename Alloc>
+  void ThreadAllocator<Alloc>::_drain()
+  {
+    t_thread_block *block = this->_remoteBlocks.exchange(nullptr, std::memory_order_acquire);
+    t_thread_block *next;
+
+    while (block)
+    {
+      next = block->next;
+      this->_allocator.free(block);
+      block = next;
+    }
+  }
+
+  template <typename Alloc>
+  ThreadAllocator<Alloc> &ThreadAllocator<Alloc>::local()
+  {
+    if (_local.instance == nullptr)
+      _local.instance = _acquire();
+    return (*_local.instance);
+  }
+
+  template <typename Alloc>
+  bool ThreadAllocator<Alloc>::isExiting()
+  {
+    return (_local.exiting);
+  }
+
+  template <typename Alloc>
+  TRACE_ALLOCATOR_CODE void *ThreadAllocator<Alloc>::allocate(std::uint64_t const size)
+  {
+    return (this->allocate(size, DEFAULT_ALIGN_SIZE));
+  }
+
+  template <typename Alloc>
+  TRACE_ALLOCATOR_CODE void *ThreadAllocator<Alloc>::allocate(std::uint64_t const size, std::uint64_t const alignment)
+  {
+    std::uint64_t padding = MAX(alignment, this->_headerSize);
+    std::uintptr_t *header;
+    char *block;
+
+    if (this->_remoteBlocks.load(std::memory_order_relaxed) != nullptr)
+      this->_drain();
+    block = (char *) this->_allocator.allocate(size + padding, alignment);
+    header = (std::uintptr_t *) (block + padding);
+    header[-1] = (std::uintptr_t) this;
+    if (padding != this->_headerSize)
+    {
+      header[-1] |= THREAD_BLOCK_PADDED;
+      header[-2] = (std::uintptr_t) block;
+    }
+    return (block + padding);
+  }
+
+  template <typename Alloc>
+  void ThreadAllocator<Alloc>::free(void *ptr)
+  {
+    std::uintptr_t *header = (std::uintptr_t *) ptr;
+    ThreadAllocator *owner = (ThreadAllocator *) (header[-1] & ~((std::uintptr_t) THREAD_BLOCK_PADDED));
+    t_thread_block *block;
+
+    if (header[-1] & THREAD_BLOCK_PADDED)
+      block = (t_thread_block *) header[-2];
+    else
+      block = (t_thread_block *) (((char *) ptr) - owner->_headerSize);
+    if (owner == _local.instance)
+      owner->_allocator.free(block);
+    else
+      owner->_remoteFree(block);
+  }
+
+  template class ThreadAllocator<FrameAllocator>;
+  template class ThreadAllocator<StackAllocator>;
+  template class ThreadAllocator<PoolAllocator>;
+};
\ No newline at end of file
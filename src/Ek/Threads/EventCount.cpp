@@ -0,0 +1,102 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <climits>
+
+#include "Ek/Threads/EventCount.hpp"
+
+#ifdef __linux__
+  #include <linux/futex.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+namespace ek
+{
+#ifdef __linux__
+  static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "EventCount: the epoch must be usable as a futex");
+#endif
+
+  EventCount::EventCount() :
+    _epoch(0),
+    _waiters(0)
+  {
+  }
+
+  std::uint32_t EventCount::prepareWait()
+  {
+    this->_waiters.fetch_add(1, std::memory_order_seq_cst);
+    return (this->_epoch.load(std::memory_order_seq_cst));
+  }
+
+  void EventCount::cancelWait()
+  {
+    this->_waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void EventCount::wait(std::uint32_t const key)
+  {
+#ifdef __linux__
+    /* Returns at once if an event came since prepareWait() */
+    syscall(SYS_futex, (std::uint32_t *) &this->_epoch, FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+#else
+    std::unique_lock<std::mutex> lock(this->_mutex);
+
+    while (this->_epoch.load(std::memory_order_relaxed) == key)
+      this->_condition.wait(lock);
+#endif
+    this->_waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void EventCount::_notify(bool const all)
+  {
+    /* Orders the condition set by the caller before the load of the waiters */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!this->_waiters.load(std::memory_order_relaxed))
+      return;
+
+#ifdef __linux__
+    this->_epoch.fetch_add(1, std::memory_order_seq_cst);
+    syscall(SYS_futex, (std::uint32_t *) &this->_epoch, FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, nullptr, nullptr, 0);
+#else
+    {
+      std::lock_guard<std::mutex> lock(this->_mutex);
+      this->_epoch.fetch_add(1, std::memory_order_seq_cst);
+    }
+    if (all)
+      this->_condition.notify_all();
+    else
+      this->_condition.notify_one();
+#endif
+  }
+
+  void EventCount::notifyOne()
+  {
+    this->_notify(false);
+  }
+
+  void EventCount::notifyAll()
+  {
+    this->_notify(true);
+  }
+};
\ No newline at end of file
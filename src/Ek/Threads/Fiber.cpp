@@ -0,0 +1,151 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include "Ek/Threads/Fiber.hpp"
+
+#ifdef EK_FIBERS
+
+#ifdef __SANITIZE_THREAD__
+  #include <sanitizer/tsan_interface.h>
+#endif
+
+extern "C"
+{
+  void ek_fiber_switch(void **, void *);
+  void ek_fiber_start();
+}
+
+/*
+** ek_fiber_switch(from, to): pushes the callee saved registers and the
+** floating point control words, stores the stack pointer in *from, then
+** pops the same frame from the stack of to.
+** ek_fiber_start: first return of a fiber, calls entry(arg) from r13 and r12.
+*/
+asm(R"(
+  .text
+  .p2align 4
+  .globl ek_fiber_switch
+  .hidden ek_fiber_switch
+  .type ek_fiber_switch, @function
+ek_fiber_switch:
+  pushq %rbp
+  pushq %rbx
+  pushq %r12
+  pushq %r13
+  pushq %r14
+  pushq %r15
+  subq $8, %rsp
+  stmxcsr (%rsp)
+  fnstcw 4(%rsp)
+  movq %rsp, (%rdi)
+  movq %rsi, %rsp
+  ldmxcsr (%rsp)
+  fldcw 4(%rsp)
+  addq $8, %rsp
+  popq %r15
+  popq %r14
+  popq %r13
+  popq %r12
+  popq %rbx
+  popq %rbp
+  ret
+  .size ek_fiber_switch, .-ek_fiber_switch
+
+  .p2align 4
+  .globl ek_fiber_start
+  .hidden ek_fiber_start
+  .type ek_fiber_start, @function
+ek_fiber_start:
+  movq %r12, %rdi
+  callq *%r13
+  ud2
+  .size ek_fiber_start, .-ek_fiber_start
+)");
+
+#endif
+
+namespace ek
+{
+  Fiber::Fiber() :
+    _stackPointer(nullptr)
+  {
+#ifdef __SANITIZE_THREAD__
+    /* Known on the first switch away, from the thread itself */
+    this->_tsanFiber = nullptr;
+    this->_ownsTsanFiber = false;
+#endif
+  }
+
+  Fiber::Fiber(void *stack, std::uint64_t const size, void (*entry)(void *), void *arg) :
+    _stackPointer(nullptr)
+  {
+#ifdef EK_FIBERS
+    /* The frame popped by the first switch: entry and arg land in r13 and r12 */
+    void **top = (void **) (((std::uintptr_t) stack + size) & ~(std::uintptr_t) 15);
+    std::uint32_t fpu[2] = {FIBER_DEFAULT_MXCSR, FIBER_DEFAULT_FPU_CONTROL};
+
+    *--top = (void *) &ek_fiber_start;
+    *--top = nullptr;
+    *--top = nullptr;
+    *--top = arg;
+    *--top = (void *) entry;
+    *--top = nullptr;
+    *--top = nullptr;
+    --top;
+    __builtin_memcpy(top, fpu, sizeof(fpu));
+    this->_stackPointer = top;
+#else
+    (void) stack;
+    (void) size;
+    (void) entry;
+    (void) arg;
+#endif
+#ifdef __SANITIZE_THREAD__
+    this->_tsanFiber = __tsan_create_fiber(0);
+    this->_ownsTsanFiber = true;
+#endif
+  }
+
+  Fiber::~Fiber()
+  {
+#ifdef __SANITIZE_THREAD__
+    if (this->_ownsTsanFiber)
+      __tsan_destroy_fiber(this->_tsanFiber);
+#endif
+  }
+
+  void Fiber::switchTo(Fiber &from, Fiber &to)
+  {
+#ifdef EK_FIBERS
+  #ifdef __SANITIZE_THREAD__
+    if (!from._tsanFiber)
+      from._tsanFiber = __tsan_get_current_fiber();
+    __tsan_switch_to_fiber(to._tsanFiber, 0);
+  #endif
+    ek_fiber_switch(&from._stackPointer, to._stackPointer);
+#else
+    (void) from;
+    (void) to;
+#endif
+  }
+};
\ No newline at end of file
@@ -0,0 +1,528 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <functional>
+
+#include "Ek/Utils/Logger.hpp"
+#include "Ek/Utils/Maths.hpp"
+#include "Ek/Threads/JobManager.hpp"
+
+#ifdef EK_FIBERS
+  #include <sys/mman.h>
+
+  /* A fiber may resume on another thread: thread locals are read again after each switch */
+  #define JOB_THREAD_LOCAL __attribute__((noinline))
+#else
+  #define JOB_THREAD_LOCAL
+#endif
+
+namespace ek
+{
+  std::atomic<std::uint64_t> JobManager::_nextId(1);
+  thread_local JobManager::t_job_thread_slot JobManager::_slots[JOB_THREAD_SLOTS] = {};
+  thread_local std::uint32_t JobManager::_nextSlot = 0;
+
+  JobManager::JobManager(std::uint32_t workerCount, std::uint32_t fiberCount, std::uint64_t affinity) :
+    _id(_nextId.fetch_add(1, std::memory_order_relaxed)),
+    _affinity(affinity),
+    _jobAllocator(DEFAULT_PAGE_SIZE, JOB_SIZE),
+    _waiterAllocator(DEFAULT_PAGE_SIZE, sizeof(t_job_waiter)),
+    _queueCount(0),
+    _running(true),
+    _pendingJobs(0),
+    _stackProvider(JOB_FIBER_STACK_SIZE, MAX(fiberCount, 1u) * (std::uint64_t) JOB_FIBER_STACK_SIZE)
+  {
+    DEBUG("JobManager: Constructor");
+
+    /* The calling thread runs jobs too while it waits for them */
+    if (!workerCount)
+    {
+      workerCount = std::thread::hardware_concurrency();
+      workerCount = workerCount > 1 ? workerCount - 1 : 0;
+    }
+    workerCount = MAX(workerCount, (std::uint32_t) JOB_MIN_WORKERS);
+    workerCount = MIN(workerCount, (std::uint32_t) JOB_MAX_QUEUES / 2);
+
+    /* Before any worker: they take fibers as soon as they start */
+    if (fiberCount)
+      this->_createFibers(fiberCount);
+
+    for (std::uint32_t i = 0; i < JOB_MAX_QUEUES; i++)
+      this->_queues[i].store(nullptr, std::memory_order_relaxed);
+
+    /* Worker queues come first, owned by their worker */
+    for (std::uint32_t i = 0; i < workerCount; i++)
+      this->_queues[i].store(new JobQueue(), std::memory_order_relaxed);
+    this->_queueCount.store(workerCount, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(this->_queuesMutex);
+    for (std::uint32_t i = 0; i < workerCount; i++)
+    {
+      this->_workers.emplace_back(&JobManager::_work, this, i);
+      this->_queues[i].load(std::memory_order_relaxed)->setOwner(this->_workers.back().get_id());
+    }
+  }
+
+  JobManager::~JobManager()
+  {
+    DEBUG("JobManager: Destructor");
+
+    this->wait();
+    this->_running.store(false, std::memory_order_release);
+    this->_events.notifyAll();
+    for (std::thread &worker : this->_workers)
+      worker.join();
+
+    for (std::uint32_t i = 0; i < this->_queueCount.load(std::memory_order_relaxed); i++)
+      delete this->_queues[i].load(std::memory_order_relaxed);
+
+    for (t_job_thread *thread : this->_threads)
+      delete thread;
+
+    /* The stacks go with the ranges of the provider */
+    for (t_job_fiber *fiber : this->_fibers)
+      fiber->~t_job_fiber();
+  }
+
+  void JobManager::_createFibers(std::uint32_t const count)
+  {
+#ifdef EK_FIBERS
+    char *stacks = (char *) this->_stackProvider.allocate(count * (std::uint64_t) JOB_FIBER_STACK_SIZE);
+
+    this->_fibers.reserve(count);
+    this->_freeFibers.reserve(count);
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+      char *stack = stacks + i * (std::uint64_t) JOB_FIBER_STACK_SIZE;
+      char *top = stack + JOB_FIBER_STACK_SIZE - ALIGN(sizeof(t_job_fiber), JOB_DATA_ALIGN);
+      t_job_fiber *fiber;
+
+      /* An overflow faults on the guard page instead of writing over the fiber below */
+      if (mprotect(stack, JOB_FIBER_GUARD_SIZE, PROT_NONE) != 0)
+        WARN("JobManager: Cannot protect the guard page of fiber " << i);
+
+      fiber = (t_job_fiber *) top;
+      new (&fiber->context) Fiber(stack + JOB_FIBER_GUARD_SIZE, top - stack - JOB_FIBER_GUARD_SIZE, &JobManager::_runFiber, fiber);
+      fiber->resume.execute = nullptr;
+      fiber->resume.counter = nullptr;
+      fiber->resume.fiber = fiber;
+      fiber->resume.manager = this;
+      fiber->job = nullptr;
+      fiber->manager = this;
+      fiber->next = nullptr;
+      this->_fibers.push_back(fiber);
+      this->_freeFibers.push_back(fiber);
+    }
+#else
+    WARN("JobManager: No fiber on this platform, " << count << " fibers asked");
+#endif
+  }
+
+  t_job_fiber *JobManager::_acquireFiber(t_job_thread &local)
+  {
+    t_job_fiber *fiber;
+
+    if (local.fiberCount)
+      return (local.fibers[--local.fiberCount]);
+    if (this->_fibers.empty())
+      return (nullptr);
+
+    std::lock_guard<std::mutex> lock(this->_fibersMutex);
+    if (this->_freeFibers.empty())
+      return (nullptr);
+
+    /* Workers take a few more, to come back less often */
+    while (local.worker && local.fiberCount < JOB_FIBER_CACHE_SIZE / 2 && this->_freeFibers.size() > 1)
+    {
+      local.fibers[local.fiberCount++] = this->_freeFibers.back();
+      this->_freeFibers.pop_back();
+    }
+    fiber = this->_freeFibers.back();
+    this->_freeFibers.pop_back();
+    return (fiber);
+  }
+
+  void JobManager::_releaseFiber(t_job_thread &local, t_job_fiber *fiber)
+  {
+    /* Other threads may leave: only workers keep fibers */
+    if (local.worker && local.fiberCount < JOB_FIBER_CACHE_SIZE)
+    {
+      local.fibers[local.fiberCount++] = fiber;
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(this->_fibersMutex);
+    this->_freeFibers.push_back(fiber);
+    while (local.fiberCount > JOB_FIBER_CACHE_SIZE / 2)
+      this->_freeFibers.push_back(local.fibers[--local.fiberCount]);
+  }
+
+  void JobManager::_runFiber(void *data)
+  {
+    t_job_fiber *fiber = (t_job_fiber *) data;
+
+    while (true)
+    {
+      fiber->manager->_execute(fiber->job);
+
+      /* Back to the thread running the fiber now, which may not be the one which started it */
+      Fiber::switchTo(fiber->context, fiber->manager->_local().context);
+    }
+  }
+
+  void JobManager::_suspend(JobCounter &counter)
+  {
+    while (!counter.isDone())
+    {
+      t_job_thread &local = this->_local();
+
+      /* At zero, its last job still leaving it */
+      if (counter.getValue() == 0)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      /* The thread parks the fiber on the counter once off its stack */
+      local.waitCounter = &counter;
+      Fiber::switchTo(local.fiber->context, local.context);
+    }
+  }
+
+  void JobManager::_run(t_job_thread &local, t_job *job)
+  {
+    t_job_fiber *fiber = job->fiber;
+
+    if (fiber && local.fiber)
+    {
+      /* A fiber is only resumed from a thread stack: kept until the running one leaves */
+      fiber->next = local.resumable;
+      local.resumable = fiber;
+      return;
+    }
+    if (!fiber)
+    {
+      if (local.fiber)
+      {
+        this->_execute(job);
+        return;
+      }
+      if (!(fiber = this->_acquireFiber(local)))
+      {
+        local.depth++;
+        this->_execute(job);
+        local.depth--;
+        return;
+      }
+      fiber->job = job;
+    }
+
+    local.fiber = fiber;
+    Fiber::switchTo(local.context, fiber->context);
+    local.fiber = nullptr;
+
+    if (local.waitCounter)
+    {
+      JobCounter *counter = local.waitCounter;
+
+      local.waitCounter = nullptr;
+      this->_depend(&fiber->resume, {counter});
+    }
+    else
+      this->_releaseFiber(local, fiber);
+
+    while (local.resumable)
+    {
+      fiber = local.resumable;
+      local.resumable = fiber->next;
+      this->_run(local, &fiber->resume);
+    }
+  }
+
+  t_job *JobManager::_allocJob(JobCounter *counter)
+  {
+    t_job *job = (t_job *) this->_jobAllocator.allocate(JOB_SIZE);
+
+    /* Counted from now on, even while waiting for dependencies */
+    job->counter = counter;
+    job->fiber = nullptr;
+    job->manager = this;
+    if (counter)
+      counter->_value.fetch_add(1, std::memory_order_seq_cst);
+    this->_pendingJobs.fetch_add(1, std::memory_order_relaxed);
+    return (job);
+  }
+
+  void JobManager::_submit(t_job *job)
+  {
+    t_job_thread &local = this->_local();
+
+    if (!local.queue || !local.queue->push(job))
+    {
+      this->_run(local, job);
+      return;
+    }
+    this->_events.notifyOne();
+  }
+
+  void JobManager::_execute(t_job *job)
+  {
+    JobManager *manager = job->manager;
+    JobCounter *counter = job->counter;
+
+    job->execute(job);
+    manager->_jobAllocator.free(job);
+
+    /* Last job of the group: the jobs waiting for it are queued */
+    if (counter)
+    {
+      counter->_releasing.fetch_add(1, std::memory_order_relaxed);
+      if (counter->_value.fetch_sub(1, std::memory_order_seq_cst) == 1)
+        this->_release(counter);
+      counter->_releasing.fetch_sub(1, std::memory_order_release);
+    }
+    /* Publishes the work of the job to wait() */
+    manager->_pendingJobs.fetch_sub(1, std::memory_order_release);
+  }
+
+  void JobManager::_depend(t_job *job, std::initializer_list<JobCounter *> const &dependencies)
+  {
+    /* The extra dependency keeps the job out of the queues until every waiter is set */
+    job->dependencies.store(dependencies.size() + 1, std::memory_order_relaxed);
+
+    for (JobCounter *counter : dependencies)
+    {
+      t_job_waiter *waiter = (t_job_waiter *) this->_waiterAllocator.allocate(sizeof(t_job_waiter));
+
+      waiter->job = job;
+      waiter->manager = this;
+      waiter->next = counter->_waiters.load(std::memory_order_relaxed);
+      while (!counter->_waiters.compare_exchange_weak(waiter->next, waiter, std::memory_order_seq_cst, std::memory_order_relaxed));
+
+      /* Already at zero, or reached it before the waiter was seen */
+      if (counter->_value.load(std::memory_order_seq_cst) == 0)
+        this->_release(counter);
+    }
+    this->_resolve(job);
+  }
+
+  void JobManager::_resolve(t_job *job)
+  {
+    /* A counter may be shared by jobs of several managers */
+    if (job->dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      job->manager->_submit(job);
+  }
+
+  void JobManager::_release(JobCounter *counter)
+  {
+    /* Each waiter is taken by a single thread, even if several release the counter */
+    t_job_waiter *waiter = counter->_waiters.exchange(nullptr, std::memory_order_seq_cst);
+
+    while (waiter)
+    {
+      t_job_waiter *next = waiter->next;
+
+      this->_resolve(waiter->job);
+      waiter->manager->_waiterAllocator.free(waiter);
+      waiter = next;
+    }
+  }
+
+  JOB_THREAD_LOCAL JobManager::t_job_thread &JobManager::_local()
+  {
+    t_job_thread_slot *slot;
+
+    for (std::uint32_t i = 0; i < JOB_THREAD_SLOTS; i++)
+      if (_slots[i].manager == this->_id)
+        return (*_slots[i].thread);
+
+    /* The state stays in the manager: a slot taken back only costs a lookup */
+    slot = &_slots[_nextSlot++ % JOB_THREAD_SLOTS];
+    slot->manager = this->_id;
+    slot->thread = this->_register(std::this_thread::get_id());
+    return (*slot->thread);
+  }
+
+  JobManager::t_job_thread *JobManager::_register(std::thread::id const owner)
+  {
+    std::lock_guard<std::mutex> lock(this->_queuesMutex);
+    std::uint32_t count = this->_queueCount.load(std::memory_order_relaxed);
+    t_job_thread *thread;
+
+    for (t_job_thread *known : this->_threads)
+      if (known->owner == owner)
+        return (known);
+
+    /* First use of this manager by the thread */
+    thread = new t_job_thread();
+    thread->owner = owner;
+    thread->queue = nullptr;
+    thread->random = (std::uint32_t) std::hash<std::thread::id>()(owner) | 1;
+    this->_threads.push_back(thread);
+
+    /* Workers own a queue from the start */
+    for (std::uint32_t i = 0; i < count; i++)
+      if (this->_queues[i].load(std::memory_order_relaxed)->getOwner() == owner)
+        thread->queue = this->_queues[i].load(std::memory_order_relaxed);
+    if (thread->queue)
+      return (thread);
+
+    if (count == JOB_MAX_QUEUES)
+    {
+      WARN("JobManager: Too many threads adding jobs, jobs of this one run right away");
+      return (thread);
+    }
+    thread->queue = new JobQueue();
+    thread->queue->setOwner(owner);
+    this->_queues[count].store(thread->queue, std::memory_order_relaxed);
+    this->_queueCount.store(count + 1, std::memory_order_release);
+    return (thread);
+  }
+
+  t_job *JobManager::_findJob(t_job_thread &local)
+  {
+    t_job *job = nullptr;
+
+    if (local.queue)
+      job = local.queue->pop();
+    if (!job)
+      job = this->_steal(local);
+    return (job);
+  }
+
+  t_job *JobManager::_steal(t_job_thread &local)
+  {
+    std::uint32_t count = this->_queueCount.load(std::memory_order_acquire);
+    std::uint32_t start;
+
+    /* xorshift: victims differ from a thief to another */
+    local.random ^= local.random << 13;
+    local.random ^= local.random >> 17;
+    local.random ^= local.random << 5;
+    start = local.random % count;
+
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+      JobQueue *queue = this->_queues[(start + i) % count].load(std::memory_order_relaxed);
+      t_job *job;
+
+      if (queue != local.queue && (job = queue->steal()))
+        return (job);
+    }
+    return (nullptr);
+  }
+
+  void JobManager::_work(std::uint32_t const index)
+  {
+    t_job_thread &local = this->_local();
+    std::uint32_t spins = 0;
+    std::uint32_t key;
+    t_job *job;
+
+    local.worker = true;
+    ThreadManager::setCurrentName("ek-worker-" + std::to_string(index));
+    if (this->_affinity != THREAD_ANY_CORE)
+      ThreadManager::setCurrentAffinity(this->_affinity);
+    while (this->_running.load(std::memory_order_acquire))
+    {
+      if ((job = this->_findJob(local)))
+      {
+        this->_run(local, job);
+        spins = 0;
+        continue;
+      }
+      if (++spins < JOB_SPIN_COUNT)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      /* Jobs added from here on wake the worker up */
+      key = this->_events.prepareWait();
+      if ((job = this->_findJob(local)) || !this->_running.load(std::memory_order_acquire))
+      {
+        this->_events.cancelWait();
+        if (job)
+          this->_run(local, job);
+        continue;
+      }
+      this->_events.wait(key);
+      spins = 0;
+    }
+  }
+
+  void JobManager::run(void (*function)(void *), void *data, JobCounter *counter)
+  {
+    this->run([function, data] {
+      function(data);
+    }, counter);
+  }
+
+  void JobManager::wait()
+  {
+    t_job_thread &local = this->_local();
+    t_job *job;
+
+    if (local.fiber || local.depth)
+    {
+      ERROR("JobManager: wait() called from a job, which would wait for itself");
+      return;
+    }
+    while (this->_pendingJobs.load(std::memory_order_acquire) > 0)
+    {
+      if ((job = this->_findJob(local)))
+        this->_run(local, job);
+      else
+        std::this_thread::yield();
+    }
+  }
+
+  void JobManager::wait(JobCounter &counter)
+  {
+    t_job_thread &local = this->_local();
+    t_job *job;
+
+    if (local.fiber)
+    {
+      this->_suspend(counter);
+      return;
+    }
+    while (!counter.isDone())
+    {
+      if ((job = this->_findJob(local)))
+        this->_run(local, job);
+      else
+        std::this_thread::yield();
+    }
+  }
+
+  std::uint32_t JobManager::getWorkerCount() const
+  {
+    return ((std::uint32_t) this->_workers.size());
+  }
+
+  std::uint32_t JobManager::getFiberCount() const
+  {
+    return ((std::uint32_t) this->_fibers.size());
+  }
+};
\ No newline at end of file
@@ -0,0 +1,118 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include "Ek/Utils/Logger.hpp"
+#include "Ek/Threads/JobQueue.hpp"
+
+namespace ek
+{
+  JobQueue::JobQueue(std::uint64_t size) :
+    _top(0),
+    _bottom(0),
+    _size(1)
+  {
+    DEBUG("JobQueue: Constructor");
+
+    while ((std::uint64_t) this->_size < size)
+      this->_size <<= 1;
+    this->_jobs = new std::atomic<t_job *>[this->_size];
+    for (std::int64_t i = 0; i < this->_size; i++)
+      this->_jobs[i].store(nullptr, std::memory_order_relaxed);
+  }
+
+  JobQueue::~JobQueue()
+  {
+    DEBUG("JobQueue: Destructor");
+
+    delete[] this->_jobs;
+  }
+
+  bool JobQueue::push(t_job *job)
+  {
+    std::int64_t bottom = this->_bottom.load(std::memory_order_relaxed);
+    std::int64_t top = this->_top.load(std::memory_order_acquire);
+
+    if (bottom - top >= this->_size)
+      return (false);
+    this->_jobs[bottom & (this->_size - 1)].store(job, std::memory_order_relaxed);
+    /* Publishes the job, and its content, to thieves */
+    this->_bottom.store(bottom + 1, std::memory_order_release);
+    return (true);
+  }
+
+  t_job *JobQueue::pop()
+  {
+    std::int64_t bottom = this->_bottom.load(std::memory_order_relaxed) - 1;
+    std::int64_t top;
+    t_job *job;
+
+    /* Takes the bottom job, then checks no thief took it meanwhile */
+    this->_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    top = this->_top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+      this->_bottom.store(bottom + 1, std::memory_order_relaxed);
+      return (nullptr);
+    }
+
+    job = this->_jobs[bottom & (this->_size - 1)].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+      /* Last job: the owner and the thieves race for it on the top */
+      if (!this->_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        job = nullptr;
+      this->_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return (job);
+  }
+
+  t_job *JobQueue::steal()
+  {
+    std::int64_t top = this->_top.load(std::memory_order_acquire);
+    std::int64_t bottom;
+    t_job *job;
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bottom = this->_bottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+      return (nullptr);
+
+    job = this->_jobs[top & (this->_size - 1)].load(std::memory_order_relaxed);
+    /* Lost against the owner or another thief */
+    if (!this->_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      return (nullptr);
+    return (job);
+  }
+
+  std::thread::id JobQueue::getOwner() const
+  {
+    return (this->_owner);
+  }
+
+  void JobQueue::setOwner(std::thread::id const owner)
+  {
+    this->_owner = owner;
+  }
+};
\ No newline at end of file
@@ -0,0 +1,288 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <exception>
+#include <system_error>
+
+#include "Ek/Utils/Config.hpp"
+#include "Ek/Utils/Logger.hpp"
+#include "Ek/Threads/ThreadManager.hpp"
+
+#if defined(EK_SYSTEM_WINDOWS)
+  #include <windows.h>
+#else
+  #include <pthread.h>
+  #if defined(__linux__)
+    #include <sched.h>
+    #include <sys/resource.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+  #endif
+#endif
+
+/* Nice values of the priorities, Linux threads each having their own */
+#define THREAD_NICE_LOW 10
+#define THREAD_NICE_HIGH -5
+#define THREAD_NICE_CRITICAL -10
+
+namespace ek
+{
+  ThreadManager::ThreadManager() :
+    _running(true)
+  {
+    DEBUG("ThreadManager: Constructor");
+  }
+
+  ThreadManager::~ThreadManager()
+  {
+    DEBUG("ThreadManager: Destructor");
+
+    this->stop();
+    this->join();
+  }
+
+  bool ThreadManager::spawn(std::string const &name, std::function<void(ThreadManager &)> function,
+                            std::uint64_t affinity, Priority priority, std::function<void()> wake)
+  {
+    std::lock_guard<std::mutex> lock(this->_threadsMutex);
+    std::shared_ptr<t_managed_thread> thread;
+
+    if (!this->_running.load(std::memory_order_acquire))
+    {
+      WARN("ThreadManager: Stopping, " << name << " not started");
+      return (false);
+    }
+
+    thread = std::make_shared<t_managed_thread>();
+    thread->name = name;
+    thread->affinity = affinity;
+    thread->priority = priority;
+    thread->wake = std::move(wake);
+    thread->joined = false;
+    try
+    {
+      thread->thread = std::thread(&ThreadManager::_run, this, thread, std::move(function));
+    }
+    catch (std::system_error const &e)
+    {
+      ERROR("ThreadManager: Cannot start " << name << ": " << e.what());
+      return (false);
+    }
+    /* Only listed once started: join() needs a joinable thread */
+    this->_threads.push_back(thread);
+    return (true);
+  }
+
+  void ThreadManager::_run(std::shared_ptr<t_managed_thread> thread, std::function<void(ThreadManager &)> function)
+  {
+    setCurrentName(thread->name);
+    if (thread->affinity != THREAD_ANY_CORE)
+      setCurrentAffinity(thread->affinity);
+    if (thread->priority != Normal)
+      setCurrentPriority(thread->priority);
+    DEBUG("ThreadManager: " << thread->name << " started");
+
+    try
+    {
+      function(*this);
+    }
+    catch (std::exception const &e)
+    {
+      ERROR("ThreadManager: " << thread->name << " ended on an exception: " << e.what() << ", stopping");
+      this->stop();
+    }
+    catch (...)
+    {
+      ERROR("ThreadManager: " << thread->name << " ended on an exception, stopping");
+      this->stop();
+    }
+    DEBUG("ThreadManager: " << thread->name << " ended");
+  }
+
+  bool ThreadManager::isRunning() const
+  {
+    return (this->_running.load(std::memory_order_acquire));
+  }
+
+  bool ThreadManager::sleepFor(std::chrono::nanoseconds const duration)
+  {
+    std::unique_lock<std::mutex> lock(this->_sleepMutex);
+
+    return (!this->_sleep.wait_for(lock, duration, [this] {
+      return (!this->_running.load(std::memory_order_acquire));
+    }));
+  }
+
+  void ThreadManager::stop()
+  {
+    std::vector<std::function<void()>> wakes;
+
+    {
+      std::lock_guard<std::mutex> lock(this->_sleepMutex);
+
+      if (!this->_running.exchange(false, std::memory_order_acq_rel))
+        return;
+    }
+    this->_sleep.notify_all();
+
+    /* Joined threads are woken up too: join() may still be waiting for them */
+    {
+      std::lock_guard<std::mutex> lock(this->_threadsMutex);
+
+      for (std::shared_ptr<t_managed_thread> const &thread : this->_threads)
+        if (thread->wake)
+          wakes.push_back(thread->wake);
+    }
+
+    /* Called unlocked: a wake function may use the manager */
+    for (std::function<void()> const &wake : wakes)
+      wake();
+  }
+
+  void ThreadManager::join()
+  {
+    std::shared_ptr<t_managed_thread> thread;
+
+    /* A managed thread would outlive the manager it still uses */
+    {
+      std::lock_guard<std::mutex> lock(this->_threadsMutex);
+
+      for (std::shared_ptr<t_managed_thread> const &managed : this->_threads)
+        if (managed->thread.get_id() == std::this_thread::get_id())
+        {
+          ERROR("ThreadManager: " << managed->name << " cannot join the threads, only their owner can");
+          return;
+        }
+    }
+
+    /* Threads started last may use those started first */
+    while (true)
+    {
+      {
+        std::lock_guard<std::mutex> lock(this->_threadsMutex);
+
+        thread = nullptr;
+        for (auto it = this->_threads.rbegin(); it != this->_threads.rend() && !thread; ++it)
+          if (!(*it)->joined)
+            thread = *it;
+        if (!thread)
+          return;
+        thread->joined = true;
+      }
+
+      thread->thread.join();
+    }
+  }
+
+  std::uint32_t ThreadManager::getThreadCount()
+  {
+    std::lock_guard<std::mutex> lock(this->_threadsMutex);
+    std::uint32_t count = 0;
+
+    for (std::shared_ptr<t_managed_thread> const &thread : this->_threads)
+      if (!thread->joined)
+        count++;
+    return (count);
+  }
+
+  bool ThreadManager::setCurrentName(std::string const &name)
+  {
+    std::string shortName = name.substr(0, THREAD_NAME_MAX_SIZE);
+
+#if defined(__linux__)
+    if (pthread_setname_np(pthread_self(), shortName.c_str()) == 0)
+      return (true);
+#elif defined(EK_SYSTEM_MACOS)
+    if (pthread_setname_np(shortName.c_str()) == 0)
+      return (true);
+#endif
+    WARN("ThreadManager: Cannot name thread " << name);
+    return (false);
+  }
+
+  bool ThreadManager::setCurrentAffinity(std::uint64_t const affinity)
+  {
+#if defined(__linux__)
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    for (std::uint32_t i = 0; i < 64; i++)
+      if (affinity & THREAD_CORE(i))
+        CPU_SET(i, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0)
+      return (true);
+#elif defined(EK_SYSTEM_WINDOWS)
+    if (SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) affinity) != 0)
+      return (true);
+#endif
+    WARN("ThreadManager: Cannot pin " << getCurrentName() << " on cores 0x" << std::hex << affinity << std::dec);
+    return (false);
+  }
+
+  bool ThreadManager::setCurrentPriority(Priority const priority)
+  {
+#if defined(__linux__)
+    int nice = 0;
+
+    if (priority == Low)
+      nice = THREAD_NICE_LOW;
+    else if (priority == High)
+      nice = THREAD_NICE_HIGH;
+    else if (priority == Critical)
+      nice = THREAD_NICE_CRITICAL;
+    if (setpriority(PRIO_PROCESS, (id_t) syscall(SYS_gettid), nice) == 0)
+      return (true);
+#elif defined(EK_SYSTEM_WINDOWS)
+    int value = THREAD_PRIORITY_NORMAL;
+
+    if (priority == Low)
+      value = THREAD_PRIORITY_BELOW_NORMAL;
+    else if (priority == High)
+      value = THREAD_PRIORITY_ABOVE_NORMAL;
+    else if (priority == Critical)
+      value = THREAD_PRIORITY_HIGHEST;
+    if (SetThreadPriority(GetCurrentThread(), value))
+      return (true);
+#endif
+    WARN("ThreadManager: Cannot change the priority of " << getCurrentName() << ", left as is");
+    return (false);
+  }
+
+  std::string ThreadManager::getCurrentName()
+  {
+#if defined(__linux__) || defined(EK_SYSTEM_MACOS)
+    char name[THREAD_NAME_MAX_SIZE + 1];
+
+    if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0)
+      return (name);
+#endif
+    return ("?");
+  }
+
+  std::uint32_t ThreadManager::getCoreCount()
+  {
+    std::uint32_t count = std::thread::hardware_concurrency();
+
+    return (count ? count : 1);
+  }
+};
\ No newline at end of file
@@ -0,0 +1,482 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "Ek/Utils/Config.hpp"
+#include "Ek/Utils/Maths.hpp"
+#include "Ek/Utils/Logger.hpp"
+#include "Ek/Utils/AsyncLogger.hpp"
+#include "Ek/Utils/LogFormat.hpp"
+
+#ifdef EK_SYSTEM_WINDOWS
+  #include <fcntl.h>
+  #include <io.h>
+  #include <sys/stat.h>
+#else
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace ek
+{
+  namespace
+  {
+    long writeFd(int const fd, char const *data, std::uint64_t const size)
+    {
+#ifdef EK_SYSTEM_WINDOWS
+      return (_write(fd, data, (unsigned int) size));
+#else
+      return (::write(fd, data, size));
+#endif
+    }
+
+    int openFd(std::string const &path)
+    {
+#ifdef EK_SYSTEM_WINDOWS
+      return (_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND, _S_IREAD | _S_IWRITE));
+#else
+      return (::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644));
+#endif
+    }
+
+    void closeFd(int const fd)
+    {
+#ifdef EK_SYSTEM_WINDOWS
+      _close(fd);
+#else
+      ::close(fd);
+#endif
+    }
+  };
+
+  /* Gathers a record, then commits it to the ring of the thread on flush */
+  class AsyncLogger::RecordBuffer : public std::streambuf
+  {
+  private:
+    AsyncLogger *_logger;
+    t_log_ring *_ring;
+    char _record[LOG_RECORD_MAX_SIZE];
+
+    /* Room is left for the header of a binary record, and for a line feed */
+    void _reset()
+    {
+      this->setp(this->_record + LOG_RECORD_HEADER_SIZE, this->_record + LOG_RECORD_MAX_SIZE - 1);
+    }
+
+  protected:
+    int overflow(int c) override
+    {
+      /* Record full: the rest is truncated */
+      return (c == traits_type::eof() ? traits_type::not_eof(c) : c);
+    }
+
+    int sync() override
+    {
+      std::uint64_t size = this->pptr() - this->pbase();
+      char *record = this->pbase();
+
+      if (size > 0 && this->_logger)
+      {
+        if (this->_logger->_encoding == Binary)
+        {
+          std::uint16_t recordSize;
+
+          if (record[size - 1] == '\n')
+            size--;
+          record -= LOG_RECORD_HEADER_SIZE;
+          size += LOG_RECORD_HEADER_SIZE;
+          recordSize = size;
+          record[0] = LOG_RECORD_TEXT;
+          std::memcpy(record + 1, &recordSize, sizeof(recordSize));
+        }
+        else if (record[size - 1] != '\n')
+          record[size++] = '\n';
+        this->_logger->_push(this->_ring, record, size);
+      }
+      this->_reset();
+      return (0);
+    }
+
+  public:
+    RecordBuffer() :
+      _logger(nullptr),
+      _ring(nullptr)
+    {
+      this->_reset();
+    }
+
+    void bind(AsyncLogger *logger, t_log_ring *ring)
+    {
+      this->_logger = logger;
+      this->_ring = ring;
+      this->_reset();
+    }
+
+    t_log_ring *getRing() const
+    {
+      return (this->_ring);
+    }
+  };
+
+  /* Per-thread state: the ring is handed back to the writer on thread exit */
+  class AsyncLogger::ThreadStream
+  {
+  public:
+    std::uint64_t id;
+    RecordBuffer buffer;
+    std::ostream stream;
+
+    ThreadStream() :
+      id(0),
+      stream(&buffer)
+    {
+    }
+
+    ~ThreadStream()
+    {
+      if (this->buffer.getRing() && AsyncLogger::_instanceId.load(std::memory_order_acquire) == this->id)
+        this->buffer.getRing()->closed.store(true, std::memory_order_release);
+    }
+  };
+
+  std::atomic<AsyncLogger *> AsyncLogger::_instance(nullptr);
+  std::atomic<std::uint64_t> AsyncLogger::_instanceId(0);
+  std::atomic<std::uint64_t> AsyncLogger::_nextId(1);
+
+  AsyncLogger::AsyncLogger(int fd, OverflowPolicy policy, std::uint64_t ringSize, Encoding encoding) :
+    _fd(fd),
+    _ownsFd(false),
+    _policy(policy),
+    _encoding(encoding),
+    _ringSize(ringSize)
+  {
+    this->_start();
+  }
+
+  AsyncLogger::AsyncLogger(std::string const &path, OverflowPolicy policy, std::uint64_t ringSize, Encoding encoding) :
+    _fd(openFd(path)),
+    _ownsFd(true),
+    _policy(policy),
+    _encoding(encoding),
+    _ringSize(ringSize)
+  {
+    if (this->_fd < 0)
+    {
+      ERROR("AsyncLogger: Cannot open " << path << ", logging to stderr");
+      this->_fd = 2;
+      this->_ownsFd = false;
+    }
+    this->_start();
+  }
+
+  AsyncLogger::~AsyncLogger()
+  {
+    AsyncLogger *expected = this;
+
+    DEBUG("AsyncLogger: Destructor");
+
+    /* New records go back to the standard streams, then the rings are drained one last time */
+    if (_instance.compare_exchange_strong(expected, nullptr))
+      _instanceId.store(0, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lock(this->_wakeMutex);
+      this->_running.store(false, std::memory_order_release);
+    }
+    this->_wakeUp.notify_one();
+    this->_writer.join();
+
+    for (t_log_ring *ring : this->_rings)
+    {
+      delete[] ring->data;
+      delete ring;
+    }
+    delete[] this->_batch;
+    if (this->_ownsFd)
+      closeFd(this->_fd);
+  }
+
+  void AsyncLogger::_start()
+  {
+    AsyncLogger *expected = nullptr;
+    std::uint64_t ringSize = LOG_RECORD_MAX_SIZE;
+
+    /* Whole records must fit, and the ring size is a power of two for the wrap around */
+    while (ringSize < this->_ringSize)
+      ringSize <<= 1;
+    this->_ringSize = ringSize;
+
+    this->_id = _nextId.fetch_add(1, std::memory_order_relaxed);
+    this->_running.store(true, std::memory_order_relaxed);
+    this->_wakeRequested.store(false, std::memory_order_relaxed);
+    this->_passes.store(0, std::memory_order_relaxed);
+    this->_dropped.store(0, std::memory_order_relaxed);
+    this->_reportedDrops = 0;
+    this->_batch = new char[LOG_WRITE_BATCH_SIZE];
+    this->_batchSize = 0;
+    if (this->_encoding == Binary)
+    {
+      std::memcpy(this->_batch, LOG_BINARY_MAGIC, LOG_BINARY_MAGIC_SIZE);
+      this->_batchSize = LOG_BINARY_MAGIC_SIZE;
+    }
+    this->_writer = std::thread(&AsyncLogger::_run, this);
+
+    if (_instance.compare_exchange_strong(expected, this))
+      _instanceId.store(this->_id, std::memory_order_release);
+    else
+      ERROR("AsyncLogger: Another logger is already installed");
+
+    DEBUG("AsyncLogger: Constructor");
+  }
+
+  AsyncLogger::t_log_ring *AsyncLogger::_register()
+  {
+    t_log_ring *ring = new t_log_ring;
+
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->tail.store(0, std::memory_order_relaxed);
+    ring->closed.store(false, std::memory_order_relaxed);
+    ring->data = new char[this->_ringSize];
+
+    std::lock_guard<std::mutex> lock(this->_ringsMutex);
+    this->_rings.push_back(ring);
+    return (ring);
+  }
+
+  bool AsyncLogger::_push(t_log_ring *ring, char const *record, std::uint64_t const size)
+  {
+    std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+    std::uint64_t offset;
+    std::uint64_t first;
+
+    while (this->_ringSize - (head - ring->tail.load(std::memory_order_acquire)) < size)
+    {
+      if (this->_policy == Drop || !this->_running.load(std::memory_order_acquire))
+      {
+        this->_dropped.fetch_add(1, std::memory_order_relaxed);
+        return (false);
+      }
+      this->_wake();
+      std::this_thread::yield();
+    }
+
+    offset = head & (this->_ringSize - 1);
+    first = MIN(size, this->_ringSize - offset);
+    std::memcpy(ring->data + offset, record, first);
+    std::memcpy(ring->data, record + first, size - first);
+    ring->head.store(head + size, std::memory_order_release);
+    return (true);
+  }
+
+  void AsyncLogger::_wake()
+  {
+    if (!this->_wakeRequested.exchange(true, std::memory_order_acq_rel))
+    {
+      std::lock_guard<std::mutex> lock(this->_wakeMutex);
+      this->_wakeUp.notify_one();
+    }
+  }
+
+  void AsyncLogger::_run()
+  {
+    while (this->_running.load(std::memory_order_acquire))
+    {
+      if (!this->_drain())
+      {
+        std::unique_lock<std::mutex> lock(this->_wakeMutex);
+
+        this->_wakeUp.wait_for(lock, std::chrono::milliseconds(LOG_FLUSH_INTERVAL), [this] {
+          return (!this->_running.load(std::memory_order_acquire) || this->_wakeRequested.load(std::memory_order_acquire));
+        });
+        this->_wakeRequested.store(false, std::memory_order_release);
+      }
+    }
+    this->_drain();
+  }
+
+  bool AsyncLogger::_drain()
+  {
+    std::uint64_t dropped = this->_dropped.load(std::memory_order_relaxed);
+    bool drained = false;
+
+    /* Rings are written out unlocked: a new thread registering does not wait behind the writes */
+    {
+      std::lock_guard<std::mutex> lock(this->_ringsMutex);
+      this->_drainRings.assign(this->_rings.begin(), this->_rings.end());
+    }
+
+    for (std::size_t i = 0; i < this->_drainRings.size();)
+    {
+      t_log_ring *ring = this->_drainRings[i];
+      /* Closed before the last records are read: nothing can follow them */
+      bool closed = ring->closed.load(std::memory_order_acquire);
+      std::uint64_t head = ring->head.load(std::memory_order_acquire);
+      std::uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+
+      while (tail < head)
+      {
+        std::uint64_t offset = tail & (this->_ringSize - 1);
+        std::uint64_t chunk = MIN(head - tail, this->_ringSize - offset);
+
+        chunk = MIN(chunk, LOG_WRITE_BATCH_SIZE - this->_batchSize);
+        std::memcpy(this->_batch + this->_batchSize, ring->data + offset, chunk);
+        this->_batchSize += chunk;
+        tail += chunk;
+        ring->tail.store(tail, std::memory_order_release);
+        if (this->_batchSize == LOG_WRITE_BATCH_SIZE)
+          this->_write();
+        drained = true;
+      }
+
+      /* Kept in the copy: those are the rings to remove */
+      if (closed)
+        i++;
+      else
+      {
+        this->_drainRings[i] = this->_drainRings.back();
+        this->_drainRings.pop_back();
+      }
+    }
+
+    if (!this->_drainRings.empty())
+    {
+      std::lock_guard<std::mutex> lock(this->_ringsMutex);
+
+      for (t_log_ring *ring : this->_drainRings)
+      {
+        this->_rings.erase(std::find(this->_rings.begin(), this->_rings.end(), ring));
+        delete[] ring->data;
+        delete ring;
+      }
+    }
+
+    if (dropped != this->_reportedDrops)
+    {
+      char report[LOG_RECORD_MAX_SIZE];
+      int size = std::snprintf(report + LOG_RECORD_HEADER_SIZE, sizeof(report) - LOG_RECORD_HEADER_SIZE, "WARN AsyncLogger: %llu records dropped\n", (unsigned long long) (dropped - this->_reportedDrops));
+      char *record = report + LOG_RECORD_HEADER_SIZE;
+
+      if (this->_encoding == Binary)
+      {
+        std::uint16_t recordSize = LOG_RECORD_HEADER_SIZE + size - 1;
+
+        record = report;
+        record[0] = LOG_RECORD_TEXT;
+        std::memcpy(record + 1, &recordSize, sizeof(recordSize));
+        size = recordSize;
+      }
+      if (this->_batchSize + size > LOG_WRITE_BATCH_SIZE)
+        this->_write();
+      std::memcpy(this->_batch + this->_batchSize, record, size);
+      this->_batchSize += size;
+      this->_reportedDrops = dropped;
+    }
+    if (this->_batchSize > 0)
+      this->_write();
+
+    {
+      std::lock_guard<std::mutex> lock(this->_flushMutex);
+      this->_passes.fetch_add(1, std::memory_order_release);
+    }
+    this->_flushed.notify_all();
+    return (drained);
+  }
+
+  void AsyncLogger::_write()
+  {
+    std::uint64_t written = 0;
+
+    while (written < this->_batchSize)
+    {
+      long result = writeFd(this->_fd, this->_batch + written, this->_batchSize - written);
+
+      if (result < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        break;
+      }
+      written += result;
+    }
+    this->_batchSize = 0;
+  }
+
+  AsyncLogger::ThreadStream &AsyncLogger::_local()
+  {
+    static thread_local ThreadStream local;
+
+    if (local.id != this->_id)
+    {
+      local.buffer.bind(this, this->_register());
+      local.id = this->_id;
+    }
+    return (local);
+  }
+
+  std::ostream &AsyncLogger::stream()
+  {
+    return (this->_local().stream);
+  }
+
+  bool AsyncLogger::write(char const *record, std::uint64_t const size)
+  {
+    return (this->_push(this->_local().buffer.getRing(), record, size));
+  }
+
+  void AsyncLogger::flush()
+  {
+    /* The pass running at the call may have passed the ring already: wait for the next one to end */
+    std::uint64_t target = this->_passes.load(std::memory_order_acquire) + 2;
+    std::unique_lock<std::mutex> lock(this->_flushMutex);
+
+    while (this->_passes.load(std::memory_order_acquire) < target)
+    {
+      this->_wake();
+      this->_flushed.wait_for(lock, std::chrono::milliseconds(LOG_FLUSH_INTERVAL));
+    }
+  }
+
+  std::uint64_t AsyncLogger::getDroppedCount() const
+  {
+    return (this->_dropped.load(std::memory_order_relaxed));
+  }
+
+  std::uint64_t AsyncLogger::getId() const
+  {
+    return (this->_id);
+  }
+
+  bool AsyncLogger::isBinary() const
+  {
+    return (this->_encoding == Binary);
+  }
+
+  AsyncLogger *AsyncLogger::getInstance()
+  {
+    return (_instance.load(std::memory_order_acquire));
+  }
+};
\ No newline at end of file
@@ -0,0 +1,312 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <chrono>
+#include <cstring>
+
+#include "Ek/Utils/Maths.hpp"
+#include "Ek/Utils/LogFormat.hpp"
+
+namespace ek
+{
+  namespace
+  {
+    std::atomic<std::uint32_t> nextId(1);
+
+    /* Reads a varint, false when it is cut */
+    bool readVarint(char const *args, std::uint64_t const size, std::uint64_t &offset, std::uint64_t &value)
+    {
+      value = 0;
+      for (unsigned int shift = 0; offset < size && shift < 64; shift += 7)
+      {
+        std::uint8_t byte = args[offset++];
+
+        value |= (std::uint64_t) (byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+          return (true);
+      }
+      offset = size;
+      return (false);
+    }
+
+    /* Writes the next argument of a record, false when there is none left */
+    bool formatArgument(std::ostream &stream, char const *args, std::uint64_t const size, std::uint64_t &offset)
+    {
+      std::uint8_t type;
+      std::uint64_t length = 8;
+
+      if (offset >= size)
+        return (false);
+      type = args[offset++];
+      if (type == LOG_ARG_INT || type == LOG_ARG_UINT)
+      {
+        std::uint64_t value;
+
+        if (!readVarint(args, size, offset, value))
+          return (false);
+        if (type == LOG_ARG_INT)
+          stream << (std::int64_t) ((value >> 1) ^ (~(value & 1) + 1));
+        else
+          stream << value;
+        return (true);
+      }
+      if (type == LOG_ARG_CHAR || type == LOG_ARG_BOOL)
+        length = 1;
+      else if (type == LOG_ARG_STRING)
+      {
+        std::uint16_t stringSize;
+
+        if (offset + sizeof(stringSize) > size)
+          return (false);
+        std::memcpy(&stringSize, args + offset, sizeof(stringSize));
+        offset += sizeof(stringSize);
+        length = stringSize;
+      }
+      if (offset + length > size)
+      {
+        offset = size;
+        return (false);
+      }
+
+      if (type == LOG_ARG_FLOAT)
+      {
+        double value;
+
+        std::memcpy(&value, args + offset, sizeof(value));
+        stream << value;
+      }
+      else if (type == LOG_ARG_POINTER)
+      {
+        std::uint64_t value;
+
+        std::memcpy(&value, args + offset, sizeof(value));
+        stream << "0x" << std::hex << value << std::dec;
+      }
+      else if (type == LOG_ARG_STRING)
+        stream.write(args + offset, length);
+      else if (type == LOG_ARG_CHAR)
+        stream << args[offset];
+      else if (type == LOG_ARG_BOOL)
+        stream << (args[offset] ? "true" : "false");
+      else
+      {
+        offset = size;
+        return (false);
+      }
+      offset += length;
+      return (true);
+    }
+  };
+
+  LogRecord::LogRecord(char const tag) :
+    _size(LOG_RECORD_HEADER_SIZE),
+    _full(false)
+  {
+    this->_data[0] = tag;
+  }
+
+  void LogRecord::_putArgument(std::uint8_t const type, void const *data, std::uint64_t const size)
+  {
+    if (this->_full || this->_size + 1 + size > LOG_RECORD_MAX_SIZE)
+    {
+      this->_full = true;
+      return;
+    }
+    this->_data[this->_size++] = type;
+    this->put(data, size);
+  }
+
+  void LogRecord::_putVarint(std::uint8_t const type, std::uint64_t value)
+  {
+    std::uint8_t bytes[10];
+    std::uint64_t size = 0;
+
+    while (value >= 0x80)
+    {
+      bytes[size++] = (value & 0x7F) | 0x80;
+      value >>= 7;
+    }
+    bytes[size++] = value;
+    this->_putArgument(type, bytes, size);
+  }
+
+  void LogRecord::put(void const *data, std::uint64_t const size)
+  {
+    if (this->_full || this->_size + size > LOG_RECORD_MAX_SIZE)
+    {
+      this->_full = true;
+      return;
+    }
+    std::memcpy(this->_data + this->_size, data, size);
+    this->_size += size;
+  }
+
+  void LogRecord::putString(char const *str)
+  {
+    std::uint64_t size;
+
+    if (this->_full || this->_size >= LOG_RECORD_MAX_SIZE)
+    {
+      this->_full = true;
+      return;
+    }
+    /* Truncated strings stay nul terminated */
+    size = MIN(std::strlen(str), LOG_RECORD_MAX_SIZE - this->_size - 1);
+    std::memcpy(this->_data + this->_size, str, size);
+    this->_data[this->_size + size] = '\0';
+    this->_size += size + 1;
+  }
+
+  void LogRecord::add(bool const value)
+  {
+    std::uint8_t argument = value;
+
+    this->_putArgument(LOG_ARG_BOOL, &argument, sizeof(argument));
+  }
+
+  void LogRecord::add(char const value)
+  {
+    this->_putArgument(LOG_ARG_CHAR, &value, sizeof(value));
+  }
+
+  void LogRecord::add(char const *value)
+  {
+    std::uint16_t size;
+
+    if (!value)
+      value = "(null)";
+    if (this->_full || this->_size + 1 + sizeof(size) >= LOG_RECORD_MAX_SIZE)
+    {
+      this->_full = true;
+      return;
+    }
+    size = MIN(std::strlen(value), LOG_RECORD_MAX_SIZE - this->_size - 1 - sizeof(size));
+    this->_data[this->_size++] = LOG_ARG_STRING;
+    this->put(&size, sizeof(size));
+    this->put(value, size);
+  }
+
+  void LogRecord::add(std::string const &value)
+  {
+    this->add(value.c_str());
+  }
+
+  char const *LogRecord::getData()
+  {
+    std::uint16_t size = this->_size;
+
+    std::memcpy(this->_data + 1, &size, sizeof(size));
+    return (this->_data);
+  }
+
+  std::uint64_t LogRecord::getSize() const
+  {
+    return (this->_size);
+  }
+
+  std::uint32_t LogFormat::nextSiteId()
+  {
+    return (nextId.fetch_add(1, std::memory_order_relaxed));
+  }
+
+  void LogFormat::begin(t_log_site const &site, LogRecord &record)
+  {
+    std::uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    record.put(&site.id, sizeof(site.id));
+    record.put(&time, sizeof(time));
+  }
+
+  void LogFormat::commit(t_log_site &site, LogRecord &record)
+  {
+    AsyncLogger *async = AsyncLogger::getInstance();
+
+    if (async && async->isBinary())
+    {
+      std::uint64_t writtenBy = site.writtenBy.load(std::memory_order_relaxed);
+
+      /* Another thread may log the site before its record is written: ek-log-decode reads sites first */
+      if (writtenBy != async->getId() && site.writtenBy.compare_exchange_strong(writtenBy, async->getId(), std::memory_order_relaxed))
+      {
+        LogRecord definition(LOG_RECORD_SITE);
+        std::uint8_t level = site.level;
+        std::uint64_t fileSize = std::strlen(site.file);
+
+        definition.put(&site.id, sizeof(site.id));
+        definition.put(&level, sizeof(level));
+        definition.put(&site.line, sizeof(site.line));
+        definition.putString(site.file + (fileSize > LOG_SITE_FILE_MAX_SIZE ? fileSize - LOG_SITE_FILE_MAX_SIZE : 0));
+        definition.putString(site.format);
+        /* Dropped: the next record of the statement writes it again */
+        if (!async->write(definition.getData(), definition.getSize()))
+        {
+          writtenBy = async->getId();
+          site.writtenBy.compare_exchange_strong(writtenBy, 0, std::memory_order_relaxed);
+        }
+      }
+      async->write(record.getData(), record.getSize());
+      return;
+    }
+
+    std::ostream &stream = Logger::stream(site.level);
+
+    stream << prefix(site.level);
+    format(stream, site.format, record.getData() + LOG_FORMAT_ARGS_OFFSET, record.getSize() - LOG_FORMAT_ARGS_OFFSET);
+    stream << std::endl;
+  }
+
+  char const *LogFormat::prefix(int const level)
+  {
+    if (level <= LOG_LEVEL_ERROR)
+      return ("ERR ");
+    if (level == LOG_LEVEL_WARN)
+      return ("WARN ");
+    if (level == LOG_LEVEL_DEBUG)
+      return ("DEB ");
+    return ("TRA ");
+  }
+
+  bool LogFormat::format(std::ostream &stream, char const *format, char const *args, std::uint64_t const size)
+  {
+    std::uint64_t offset = 0;
+    char const *placeholder;
+
+    while ((placeholder = std::strstr(format, "{}")))
+    {
+      stream.write(format, placeholder - format);
+      format = placeholder + 2;
+      if (!formatArgument(stream, args, size, offset))
+        stream << "{}";
+    }
+    stream << format;
+
+    /* Arguments without a placeholder */
+    while (offset < size)
+    {
+      stream << ' ';
+      if (!formatArgument(stream, args, size, offset))
+        return (false);
+    }
+    return (true);
+  }
+};
\ No newline at end of file
@@ -21,13 +21,23 @@
 // SOFTWARE.
 // 
 
+#include <atomic>
+
 #include "Ek/Utils/Logger.hpp"
+#include "Ek/Utils/AsyncLogger.hpp"
 
 namespace ek
 {
+  namespace
+  {
+    std::atomic<int> runtimeLevel(LOG_LEVEL_TRACE);
+    std::atomic<std::uint32_t> runtimeCategories(LOG_CATEGORY_ALL);
+  };
+
   void Logger::error(std::string const &str)
   {
-    std::cerr << "ERR: " << str << std::endl;
+    if (isEnabled(LOG_LEVEL_ERROR, LOG_CATEGORY_GENERAL))
+      stream(LOG_LEVEL_ERROR) << "ERR: " << str << std::endl;
   }
 
   std::ostream &Logger::error_stream()
@@ -37,7 +47,8 @@ namespace ek
 
   void Logger::warn(std::string const &str)
   {
-    std::cerr << "WRN: " << str << std::endl;
+    if (isEnabled(LOG_LEVEL_WARN, LOG_CATEGORY_GENERAL))
+      stream(LOG_LEVEL_WARN) << "WRN: " << str << std::endl;
   }
 
   std::ostream &Logger::warn_stream()
@@ -47,11 +58,38 @@ namespace ek
 
   void Logger::debug(std::string const &str)
   {
-    std::cout << "DEB: " << str << std::endl;
+    if (isEnabled(LOG_LEVEL_DEBUG, LOG_CATEGORY_GENERAL))
+      stream(LOG_LEVEL_DEBUG) << "DEB: " << str << std::endl;
   }
 
   std::ostream &Logger::debug_stream()
   {
     return (std::cout);
   }
+
+  std::ostream &Logger::stream(int const level)
+  {
+    AsyncLogger *async = AsyncLogger::getInstance();
+
+    if (async)
+      return (async->stream());
+    if (level <= LOG_LEVEL_WARN)
+      return (std::cerr);
+    return (std::cout);
+  }
+
+  void Logger::setLevel(int const level)
+  {
+    runtimeLevel.store(level, std::memory_order_relaxed);
+  }
+
+  void Logger::setCategories(std::uint32_t const categories)
+  {
+    runtimeCategories.store(categories, std::memory_order_relaxed);
+  }
+
+  bool Logger::isEnabled(int const level, std::uint32_t const category)
+  {
+    return (level <= runtimeLevel.load(std::memory_order_relaxed) && (category & runtimeCategories.load(std::memory_order_relaxed)));
+  }
 };
\ No newline at end of file
@@ -0,0 +1,195 @@
+// MIT License
+// 
+// Copyright (c) 2018 EkkoZ
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// 
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "Ek/Utils/LogFormat.hpp"
+
+/*
+** ek-log-decode [-t] [file]
+** Turns a binary log of an AsyncLogger back into text, reading the standard
+** input when no file is given. -t prints the time of the records, in
+** seconds since the epoch.
+** A log holds one session per AsyncLogger. A site may be written after the
+** first records using it, so the sites of a session are read first.
+*/
+
+typedef struct s_site {
+  int level;
+  std::uint32_t line;
+  std::string file;
+  std::string format;
+} t_site;
+
+static bool isMagic(std::string const &log, std::uint64_t const offset)
+{
+  return (log.compare(offset, LOG_BINARY_MAGIC_SIZE, LOG_BINARY_MAGIC) == 0);
+}
+
+/* Size of the record at an offset, 0 when it is cut */
+static std::uint64_t recordSize(std::string const &log, std::uint64_t const offset)
+{
+  std::uint16_t size;
+
+  if (offset + LOG_RECORD_HEADER_SIZE > log.size())
+    return (0);
+  std::memcpy(&size, log.data() + offset + 1, sizeof(size));
+  if (size < LOG_RECORD_HEADER_SIZE || offset + size > log.size())
+    return (0);
+  return (size);
+}
+
+/* Reads the sites of the session starting at an offset, returns the end of the session */
+static std::uint64_t readSites(std::string const &log, std::uint64_t offset, std::unordered_map<std::uint32_t, t_site> &sites)
+{
+  std::uint64_t size;
+
+  while (offset < log.size() && !isMagic(log, offset) && (size = recordSize(log, offset)))
+  {
+    char const *record = log.data() + offset;
+
+    if (record[0] == LOG_RECORD_SITE && size > LOG_RECORD_HEADER_SIZE + 4 + 1 + 4)
+    {
+      std::uint32_t id;
+      t_site site;
+      char const *file = record + LOG_RECORD_HEADER_SIZE + 4 + 1 + 4;
+      std::uint64_t fileSize = strnlen(file, record + size - file);
+
+      std::memcpy(&id, record + LOG_RECORD_HEADER_SIZE, sizeof(id));
+      site.level = (std::uint8_t) record[LOG_RECORD_HEADER_SIZE + 4];
+      std::memcpy(&site.line, record + LOG_RECORD_HEADER_SIZE + 4 + 1, sizeof(site.line));
+      site.file.assign(file, fileSize);
+      if (file + fileSize + 1 < record + size)
+        site.format.assign(file + fileSize + 1, strnlen(file + fileSize + 1, record + size - file - fileSize - 1));
+      sites[id] = site;
+    }
+    offset += size;
+  }
+  return (offset);
+}
+
+/* Prints the records of a session */
+static void printRecords(std::string const &log, std::uint64_t offset, std::uint64_t const end, std::unordered_map<std::uint32_t, t_site> const &sites, bool const printTime)
+{
+  while (offset < end)
+  {
+    std::uint64_t size = recordSize(log, offset);
+    char const *record = log.data() + offset;
+
+    if (record[0] == LOG_RECORD_TEXT)
+      std::cout.write(record + LOG_RECORD_HEADER_SIZE, size - LOG_RECORD_HEADER_SIZE) << std::endl;
+    else if (record[0] == LOG_RECORD_FORMAT && size >= LOG_FORMAT_ARGS_OFFSET)
+    {
+      std::uint32_t id;
+      std::uint64_t time;
+      std::unordered_map<std::uint32_t, t_site>::const_iterator site;
+
+      std::memcpy(&id, record + LOG_RECORD_HEADER_SIZE, sizeof(id));
+      std::memcpy(&time, record + LOG_RECORD_HEADER_SIZE + sizeof(id), sizeof(time));
+      if (printTime)
+      {
+        char buffer[32];
+
+        std::snprintf(buffer, sizeof(buffer), "[%llu.%06llu] ", (unsigned long long) (time / 1000000000), (unsigned long long) (time % 1000000000 / 1000));
+        std::cout << buffer;
+      }
+      site = sites.find(id);
+      if (site == sites.end())
+        std::cout << "Unknown site " << id << std::endl;
+      else
+      {
+        std::cout << ek::LogFormat::prefix(site->second.level);
+        if (!ek::LogFormat::format(std::cout, site->second.format.c_str(), record + LOG_FORMAT_ARGS_OFFSET, size - LOG_FORMAT_ARGS_OFFSET))
+          std::cout << " (broken arguments, " << site->second.file << ":" << site->second.line << ")";
+        std::cout << std::endl;
+      }
+    }
+    offset += size;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  bool printTime = false;
+  char const *path = nullptr;
+  std::stringstream input;
+  std::string log;
+  std::uint64_t offset = 0;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::strcmp(argv[i], "-t") == 0)
+      printTime = true;
+    else
+      path = argv[i];
+  }
+
+  if (path)
+  {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file)
+    {
+      std::cerr << "Cannot open " << path << std::endl;
+      return (1);
+    }
+    input << file.rdbuf();
+  }
+  else
+    input << std::cin.rdbuf();
+  log = input.str();
+
+  while (offset < log.size())
+  {
+    std::unordered_map<std::uint32_t, t_site> sites;
+    std::uint64_t end;
+
+    if (!isMagic(log, offset))
+    {
+      std::cerr << "Not a binary log, or cut at byte " << offset << std::endl;
+      return (1);
+    }
+    offset += LOG_BINARY_MAGIC_SIZE;
+    end = readSites(log, offset, sites);
+    printRecords(log, offset, end, sites, printTime);
+    offset = end;
+
+    /* Last records cut by a crash */
+    if (offset < log.size() && !isMagic(log, offset))
+    {
+      std::cerr << "Log cut at byte " << offset << std::endl;
+      return (1);
+    }
+  }
+
+  /* Done! */
+  return (0);
+}
\ No newline at end of file